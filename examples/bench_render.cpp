@@ -0,0 +1,227 @@
+/*
+MIT License
+
+Copyright (c) 2023 Cedric Jimenez
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "fonts_db.h"
+#include "scene.h"
+#include "sprite.h"
+#include "sprites_db.h"
+
+using namespace std;
+using namespace widgets;
+
+/** @brief Scene rendering animated sprites during a fixed number of frames */
+class bench_scene : public game::scene
+{
+  public:
+    /** @brief Number of frames rendered before starting the measures */
+    static constexpr int WARMUP_FRAMES = 10;
+
+    /** @brief Constructor */
+    bench_scene(game::fonts_db& fonts, sdl::window& window, int sprite_count, int frame_count)
+        : scene(fonts, window, false),
+          m_anim_db(this->get_renderer()),
+          m_sprites(),
+          m_frame_count(frame_count),
+          m_frame_index(0),
+          m_last_frame(),
+          m_frame_times(),
+          m_draw_calls(0),
+          m_batches(0),
+          m_batched_copies(0),
+          m_peak_texture_memory(0)
+    {
+        // Load sprite animations
+        m_anim_db.load_animation("Samurai1_Idle", ASSETS_DIRECTORY "/samurai/PNG/Samurai - 01/PNG Sequences/Idle", "Idle");
+        m_anim_db.load_animation("Samurai1_Walking", ASSETS_DIRECTORY "/samurai/PNG/Samurai - 01/PNG Sequences/Walking", "Walking");
+        m_anim_db.load_animation("Samurai2_Idle", ASSETS_DIRECTORY "/samurai/PNG/Samurai - 02/PNG Sequences/Idle", "Idle");
+        m_anim_db.load_animation("Samurai2_Walking", ASSETS_DIRECTORY "/samurai/PNG/Samurai - 02/PNG Sequences/Walking", "Walking");
+        m_anim_db.load_animation("Samurai3_Idle", ASSETS_DIRECTORY "/samurai/PNG/Samurai - 03/PNG Sequences/Idle", "Idle");
+        m_anim_db.load_animation("Samurai3_Walking", ASSETS_DIRECTORY "/samurai/PNG/Samurai - 03/PNG Sequences/Walking", "Walking");
+
+        // Spread the sprites over the screen
+        static const char* const SAMURAIS[] = {"Samurai1", "Samurai2", "Samurai3"};
+        const int                columns    = 10;
+        for (int i = 0; i < sprite_count; i++)
+        {
+            std::string samurai = SAMURAIS[i % 3];
+
+            auto spr = std::make_unique<sprite>(this->get_renderer());
+            spr->add_img_animation(0, m_anim_db.get(samurai + "_Idle"));
+            spr->add_img_animation(1, m_anim_db.get(samurai + "_Walking"));
+            spr->set_img_animation(i % 2);
+            spr->set_position({(i % columns) * 100 - 50, ((i / columns) % 6) * 120 - 50});
+            spr->set_framerate(30.f);
+            add_widget(*spr);
+
+            m_sprites.push_back(std::move(spr));
+        }
+    }
+
+    /** @brief Write the results of the benchmark as JSON */
+    void write_report(ostream& out)
+    {
+        // Frame time percentiles
+        std::vector<double> times = m_frame_times;
+        std::sort(times.begin(), times.end());
+        auto percentile = [&times](double p)
+        {
+            double ret = 0.;
+            if (!times.empty())
+            {
+                ret = times[static_cast<size_t>(p * static_cast<double>(times.size() - 1u))];
+            }
+            return ret;
+        };
+        double total_time = 0.;
+        for (auto time : times)
+        {
+            total_time += time;
+        }
+        double mean             = (times.empty() ? 0. : (total_time / static_cast<double>(times.size())));
+        double draws_per_second = ((total_time > 0.) ? (static_cast<double>(m_draw_calls) * 1000. / total_time) : 0.);
+        double copies_per_batch =
+            ((m_batches != 0) ? (static_cast<double>(m_batched_copies) / static_cast<double>(m_batches)) : 0.);
+
+        // Recycling of the intermediate textures
+        const sdl::texture_pool& pool = get_renderer()->get_texture_pool();
+
+        out << "{" << endl;
+        out << "  \"sprites\": " << m_sprites.size() << "," << endl;
+        out << "  \"frames\": " << times.size() << "," << endl;
+        out << "  \"frame_time_ms\": {" << endl;
+        out << "    \"mean\": " << mean << "," << endl;
+        out << "    \"p50\": " << percentile(0.50) << "," << endl;
+        out << "    \"p95\": " << percentile(0.95) << "," << endl;
+        out << "    \"p99\": " << percentile(0.99) << endl;
+        out << "  }," << endl;
+        out << "  \"draws_per_second\": " << draws_per_second << "," << endl;
+        out << "  \"peak_texture_memory_bytes\": " << m_peak_texture_memory << "," << endl;
+        out << "  \"batching\": {" << endl;
+        out << "    \"batches\": " << m_batches << "," << endl;
+        out << "    \"batched_copies\": " << m_batched_copies << "," << endl;
+        out << "    \"copies_per_batch\": " << copies_per_batch << endl;
+        out << "  }," << endl;
+        out << "  \"sprite_frames\": {" << endl;
+        out << "    \"loaded\": " << m_anim_db.get_frame_count() << "," << endl;
+        out << "    \"unique\": " << m_anim_db.get_unique_frame_count() << "," << endl;
+        out << "    \"saved_bytes\": " << m_anim_db.get_saved_bytes() << endl;
+        out << "  }," << endl;
+        out << "  \"texture_pool\": {" << endl;
+        out << "    \"hits\": " << pool->get_hit_count() << "," << endl;
+        out << "    \"misses\": " << pool->get_miss_count() << endl;
+        out << "  }" << endl;
+        out << "}" << endl;
+    }
+
+  protected:
+    /** @brief Called once the frame has been presented */
+    void on_frame_presented() override
+    {
+        // Measure the frame which has just been presented
+        auto now = chrono::steady_clock::now();
+        if (m_frame_index > WARMUP_FRAMES)
+        {
+            auto frame_time = chrono::duration_cast<chrono::microseconds>(now - m_last_frame);
+            m_frame_times.push_back(static_cast<double>(frame_time.count()) / 1000.);
+
+            const sdl::render_stats& stats = get_render_stats();
+            m_draw_calls += stats.get_draw_calls();
+            m_batches += stats.batches;
+            m_batched_copies += stats.batched_copies;
+            m_peak_texture_memory = std::max(m_peak_texture_memory, stats.texture_memory);
+        }
+        m_last_frame = now;
+
+        // Stop after the last measured frame
+        m_frame_index++;
+        if (m_frame_index > (WARMUP_FRAMES + m_frame_count))
+        {
+            stop();
+        }
+    }
+
+  private:
+    game::sprites_db                     m_anim_db;
+    std::vector<std::unique_ptr<sprite>> m_sprites;
+    int                                  m_frame_count;
+    int                                  m_frame_index;
+    chrono::steady_clock::time_point     m_last_frame;
+    std::vector<double>                  m_frame_times;
+    Uint64                               m_draw_calls;
+    Uint64                               m_batches;
+    Uint64                               m_batched_copies;
+    Uint64                               m_peak_texture_memory;
+};
+
+/** @brief Entry point */
+int main(int argc, char* argv[])
+{
+    int ret = EXIT_FAILURE;
+
+    // Parameters : [sprite count] [frame count]
+    int sprite_count = ((argc > 1) ? atoi(argv[1]) : 100);
+    int frame_count  = ((argc > 2) ? atoi(argv[2]) : 500);
+
+    // Headless rendering with the software renderer
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+
+    // Initalize SDL
+    auto sdl_lib = sdl::init(SDL_INIT_VIDEO);
+    if (sdl_lib)
+    {
+        // Create a hidden window
+        sdl::window window =
+            sdl::create_window("bench_render", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1024, 768, SDL_WINDOW_HIDDEN);
+        if (window)
+        {
+            game::fonts_db fonts;
+            cerr << "Rendering " << frame_count << " frames with " << sprite_count << " sprites" << endl;
+
+            // Run the scene
+            bench_scene scene(fonts, window, sprite_count, frame_count);
+            scene.start();
+            scene.write_report(cout);
+
+            ret = EXIT_SUCCESS;
+        }
+        else
+        {
+            cerr << "Unable to create window : " << sdl_lib->last_error() << endl;
+        }
+    }
+    else
+    {
+        cerr << "Unable to initialize SDL library : " << sdl::last_error() << endl;
+    }
+
+    return ret;
+}
@@ -18,9 +18,20 @@ along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
 
 #include "fonts_db.h"
 
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
 namespace game
 {
 
+/** @brief Constructor */
+fonts_db::fonts_db(Uint64 text_cache_size)
+    : m_fonts(), m_bitmap_fonts(), m_text_cache(sdl::create_text_cache(text_cache_size)), m_files()
+{
+}
+
 /** @brief Load a font */
 bool fonts_db::load(const std::string& file, int ptsize, const std::string& name)
 {
@@ -28,9 +39,20 @@ bool fonts_db::load(const std::string& file, int ptsize, const std::string& name
     auto iter_font = m_fonts.find(name);
     if (iter_font == m_fonts.end())
     {
-        sdl::font font = sdl::create_font(file, ptsize);
+        // Fonts loaded from the same file share a single mapping of the file
+        sdl::font        font;
+        sdl::mapped_file font_file = get_file(file);
+        if (font_file)
+        {
+            font = sdl::create_font(font_file, ptsize);
+        }
+        else
+        {
+            font = sdl::create_font(file, ptsize);
+        }
         if (font)
         {
+            font->set_text_cache(m_text_cache);
             m_fonts[name] = font;
             ret           = true;
         }
@@ -38,6 +60,17 @@ bool fonts_db::load(const std::string& file, int ptsize, const std::string& name
     return ret;
 }
 
+/** @brief Load a font at multiple point sizes, the font file is read only once */
+bool fonts_db::load_sizes(const std::string& file, const std::vector<int>& ptsizes, const std::string& name)
+{
+    bool ret = !ptsizes.empty();
+    for (int ptsize : ptsizes)
+    {
+        ret = load(file, ptsize, name + "_" + std::to_string(ptsize)) && ret;
+    }
+    return ret;
+}
+
 /** @brief Unload a font */
 bool fonts_db::unload(const std::string& name)
 {
@@ -63,4 +96,188 @@ sdl::font fonts_db::get(const std::string& name)
     return font;
 }
 
+/** @brief Load a pre-rasterized bitmap font */
+bool fonts_db::load_bitmap(const sdl::renderer& renderer, const std::string& file, const std::string& name)
+{
+    bool          ret = false;
+    std::ifstream description(file);
+    if (renderer && description && (m_bitmap_fonts.find(name) == m_bitmap_fonts.end()))
+    {
+        std::vector<sdl::texture>       pages;
+        std::vector<sdl::baked_glyph>   glyphs;
+        std::vector<sdl::baked_kerning> kernings;
+        int                             line_height = 0;
+        bool                            is_valid    = true;
+
+        // Parse the description
+        std::filesystem::path                        directory = std::filesystem::path(file).parent_path();
+        std::string                                  line;
+        std::string                                  tag;
+        std::unordered_map<std::string, std::string> values;
+        auto get_int = [&values](const char* key) { return std::atoi(values[key].c_str()); };
+        while (is_valid && std::getline(description, line))
+        {
+            parse_bmfont_line(line, tag, values);
+            if (tag == "common")
+            {
+                // The number of pages is given before they are listed
+                int page_count = get_int("pages");
+                line_height    = get_int("lineHeight");
+                is_valid       = (pages.empty() && (page_count > 0) && (page_count <= MAX_BITMAP_PAGES));
+                if (is_valid)
+                {
+                    pages.resize(static_cast<size_t>(page_count));
+                }
+            }
+            else if (tag == "page")
+            {
+                // Pages are listed by id
+                int id   = get_int("id");
+                is_valid = ((id >= 0) && (static_cast<size_t>(id) < pages.size()) && !pages[static_cast<size_t>(id)]);
+                if (is_valid)
+                {
+                    sdl::texture& page = pages[static_cast<size_t>(id)];
+                    page               = renderer->create_texture((directory / values["file"]).string());
+                    is_valid           = (page != nullptr);
+                    if (is_valid)
+                    {
+                        page->set_blend_mode(SDL_BLENDMODE_BLEND);
+                    }
+                }
+            }
+            else if (tag == "char")
+            {
+                // Glyphs must be on one of the listed pages
+                int page = get_int("page");
+                is_valid = ((page >= 0) && (static_cast<size_t>(page) < pages.size()));
+                if (is_valid)
+                {
+                    glyphs.push_back({static_cast<Uint32>(get_int("id")),
+                                      static_cast<Uint32>(page),
+                                      {get_int("x"), get_int("y"), get_int("width"), get_int("height")},
+                                      get_int("xoffset"),
+                                      get_int("yoffset"),
+                                      get_int("xadvance")});
+                }
+            }
+            else if (tag == "kerning")
+            {
+                kernings.push_back({static_cast<Uint32>(get_int("first")), static_cast<Uint32>(get_int("second")), get_int("amount")});
+            }
+            else
+            {
+                // Other informations are not needed to draw the texts
+            }
+        }
+
+        // Create the glyph atlas
+        if (is_valid && (line_height > 0))
+        {
+            sdl::glyph_atlas font = sdl::create_baked_glyph_atlas(renderer, pages, glyphs, kernings, line_height);
+            if (font)
+            {
+                m_bitmap_fonts[name] = font;
+                ret                  = true;
+            }
+        }
+    }
+    return ret;
+}
+
+/** @brief Unload a pre-rasterized bitmap font */
+bool fonts_db::unload_bitmap(const std::string& name)
+{
+    return (m_bitmap_fonts.erase(name) != 0);
+}
+
+/** @brief Get a pre-rasterized bitmap font */
+sdl::glyph_atlas fonts_db::get_bitmap(const std::string& name)
+{
+    sdl::glyph_atlas font;
+    auto             iter_font = m_bitmap_fonts.find(name);
+    if (iter_font != m_bitmap_fonts.end())
+    {
+        font = iter_font->second;
+    }
+    return font;
+}
+
+/** @brief Release all the textures held by the database, must be called before their renderer is destroyed */
+void fonts_db::release_textures()
+{
+    m_text_cache->clear();
+    m_bitmap_fonts.clear();
+}
+
+/** @brief Release the textures held by the database for a renderer, must be called before the renderer is destroyed */
+void fonts_db::release_textures(const sdl::renderer& renderer)
+{
+    m_text_cache->remove(renderer.get());
+    auto iter = m_bitmap_fonts.begin();
+    while (iter != m_bitmap_fonts.end())
+    {
+        if (iter->second->get_renderer() == renderer)
+        {
+            iter = m_bitmap_fonts.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
+/** @brief Get the memory mapping of a font file, map it if no loaded font uses it */
+sdl::mapped_file fonts_db::get_file(const std::string& file)
+{
+    sdl::mapped_file font_file;
+    auto             iter_file = m_files.find(file);
+    if (iter_file != m_files.end())
+    {
+        font_file = iter_file->second.lock();
+    }
+    if (!font_file)
+    {
+        font_file = sdl::map_file(file);
+        if (font_file)
+        {
+            m_files[file] = font_file;
+        }
+        else if (iter_file != m_files.end())
+        {
+            m_files.erase(iter_file);
+        }
+    }
+    return font_file;
+}
+
+/** @brief Split a line of a BMFont description into its tag and its values */
+void fonts_db::parse_bmfont_line(const std::string& line, std::string& tag, std::unordered_map<std::string, std::string>& values)
+{
+    std::istringstream stream(line);
+    std::string        token;
+    values.clear();
+    tag.clear();
+    stream >> tag;
+    while (stream >> token)
+    {
+        size_t equal = token.find('=');
+        if (equal != std::string::npos)
+        {
+            std::string key   = token.substr(0, equal);
+            std::string value = token.substr(equal + 1u);
+            if (!value.empty() && (value[0] == '"'))
+            {
+                // Quoted strings may contain spaces
+                while ((value.size() < 2u || value.back() != '"') && (stream >> token))
+                {
+                    value += " " + token;
+                }
+                value = value.substr(1u, ((value.size() >= 2u) && (value.back() == '"')) ? (value.size() - 2u) : std::string::npos);
+            }
+            values[key] = value;
+        }
+    }
+}
+
 } // namespace game
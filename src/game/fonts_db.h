@@ -21,16 +21,29 @@ along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "sdl_font.h"
+#include "sdl_glyph_atlas.h"
+#include "sdl_text_cache.h"
 
 namespace game
 {
 
-/** @brief Font database to avoid reloading the same fonts multiple times */
+/** @brief Font database to avoid reloading the same fonts multiple times
+ *         Pre-rasterized bitmap fonts in the BMFont text format can also be loaded to draw texts without rasterization */
 class fonts_db
 {
   public:
+    /** @brief Default maximum number of bytes of the text cache */
+    static constexpr Uint64 DEFAULT_TEXT_CACHE_SIZE = 8u * 1024u * 1024u;
+
+    /**
+     * @brief Constructor
+     * @param text_cache_size Maximum number of bytes of the textures of the texts rendered with the loaded fonts
+     */
+    fonts_db(Uint64 text_cache_size = DEFAULT_TEXT_CACHE_SIZE);
+
     /**
      * @brief Load a font
      * @param file Path to the font file
@@ -40,6 +53,15 @@ class fonts_db
      */
     bool load(const std::string& file, int ptsize, const std::string& name);
 
+    /**
+     * @brief Load a font at multiple point sizes, the font file is read only once
+     * @param file Path to the font file
+     * @param ptsizes Point sizes
+     * @param name Base name for the loaded fonts, each font is named "<name>_<ptsize>"
+     * @return true if all the fonts have been loaded, false otherwise
+     */
+    bool load_sizes(const std::string& file, const std::vector<int>& ptsizes, const std::string& name);
+
     /**
      * @brief Unload a font
      * @param name Name of the font
@@ -54,9 +76,65 @@ class fonts_db
      */
     sdl::font get(const std::string& name);
 
+    /**
+     * @brief Load a pre-rasterized bitmap font
+     * @param renderer Renderer which will draw the texts
+     * @param file Path to the font description in the BMFont text format, the pages are relative to its directory
+     * @param name Name for the loaded font
+     * @return true if the font has been loaded, false otherwise
+     */
+    bool load_bitmap(const sdl::renderer& renderer, const std::string& file, const std::string& name);
+
+    /**
+     * @brief Unload a pre-rasterized bitmap font
+     * @param name Name of the font
+     * @return true if the font has been unloaded, false otherwise
+     */
+    bool unload_bitmap(const std::string& name);
+
+    /**
+     * @brief Get a pre-rasterized bitmap font
+     * @param name Name of the font
+     * @return SDL glyph atlas object to use to draw texts with the font if the font exists, nullptr otherwise
+     */
+    sdl::glyph_atlas get_bitmap(const std::string& name);
+
+    /** @brief Release all the textures held by the database, must be called before their renderer is destroyed */
+    void release_textures();
+    /** @brief Release the textures held by the database for a renderer, must be called before the renderer is destroyed
+     *         The bitmap fonts loaded for this renderer are unloaded */
+    void release_textures(const sdl::renderer& renderer);
+
+    /** @brief Get the cache of the textures of the texts rendered with the loaded fonts */
+    const sdl::text_cache& get_text_cache() const { return m_text_cache; }
+
   private:
+    /** @brief Maximum number of pages of a bitmap font */
+    static constexpr int MAX_BITMAP_PAGES = 256;
+
     /** @brief Loaded fonts */
     std::unordered_map<std::string, sdl::font> m_fonts;
+    /** @brief Loaded bitmap fonts */
+    std::unordered_map<std::string, sdl::glyph_atlas> m_bitmap_fonts;
+    /** @brief Cache of the textures of the texts rendered with the loaded fonts */
+    sdl::text_cache m_text_cache;
+    /** @brief Font files mapped in memory, shared by all the fonts loaded from the same file */
+    std::unordered_map<std::string, std::weak_ptr<sdl::sdl_mapped_file>> m_files;
+
+    /**
+     * @brief Get the memory mapping of a font file, map it if no loaded font uses it
+     * @param file Path to the font file
+     * @return Mapped file object if the mapping was successfull, nullptr otherwise
+     */
+    sdl::mapped_file get_file(const std::string& file);
+
+    /**
+     * @brief Split a line of a BMFont description into its tag and its values
+     * @param line Line to split (ex: char id=65 x=2 y=0 ...)
+     * @param tag Tag of the line (ex: char)
+     * @param values Values indexed by key, the quotes around the strings are removed
+     */
+    static void parse_bmfont_line(const std::string& line, std::string& tag, std::unordered_map<std::string, std::string>& values);
 };
 
 } // namespace game
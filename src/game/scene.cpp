@@ -18,11 +18,10 @@ along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
 
 #include "scene.h"
 #include "fonts_db.h"
-#include "label.h"
+#include "numeric_label.h"
 
 #include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <limits>
 #include <thread>
 
 using namespace std::chrono_literals;
@@ -41,10 +40,14 @@ scene::scene(fonts_db& fonts, sdl::window& window, bool is_fixed_fps, float fps)
       m_fixed_fps(fps),
       m_fps(0.f),
       m_is_fps_display_enabled(false),
+      m_is_sprite_batching_enabled(true),
+      m_is_deferred_rendering_enabled(false),
+      m_texture_loader(),
       m_is_virtual_screen_enabled(false),
       m_virtual_screen_fit(false),
       m_virtual_screen_size{0, 0, 0, 0},
       m_virtual_screen_bg_color{0, 0, 0, 255},
+      m_is_stop_requested(false),
       m_widgets()
 {
     // Initialize the renderer for the scene
@@ -52,7 +55,12 @@ scene::scene(fonts_db& fonts, sdl::window& window, bool is_fixed_fps, float fps)
 }
 
 /** @brief Destructor */
-scene::~scene() { }
+scene::~scene()
+{
+    // Cached texts and bitmap fonts of the renderer must be released before it,
+    // the ones of the other scenes are left untouched
+    m_fonts.release_textures(m_renderer);
+}
 
 /** @brief Start the scene */
 void scene::start()
@@ -68,81 +76,113 @@ void scene::start()
     }
 
     // Label for framerate display
-    widgets::label fps_label(m_renderer);
-    fps_label.set_text("0 FPS");
-    fps_label.set_font(m_fonts.get("SCENE_FPS"));
+    widgets::numeric_label fps_label(m_renderer);
+    fps_label.set_precision(1);
+    fps_label.set_min_chars(6);
+    fps_label.set_unit(" FPS");
     fps_label.set_text_color({0, 255, 0, 0});
+    fps_label.set_font(m_fonts.get("SCENE_FPS"));
+    fps_label.set_layer(std::numeric_limits<int>::max());
 
     // Compute framerate period in case of fixed framerate
     float scene_period_us = 1000000.f / m_fixed_fps;
     auto  scene_period    = std::chrono::microseconds(static_cast<int64_t>(scene_period_us));
 
     // Initialize virtual screen
-    float        virtual_screen_ratio = 0.f;
-    sdl::texture virtual_screen_texture;
+    float               virtual_screen_ratio = 0.f;
+    sdl::texture_region virtual_screen;
     if (m_is_virtual_screen_enabled)
     {
-        virtual_screen_texture = m_renderer->create_texture(
-            SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, m_virtual_screen_size.w, m_virtual_screen_size.h);
-        if (virtual_screen_texture)
+        if (m_renderer->get_texture_pool()->acquire(
+                SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, m_virtual_screen_size.w, m_virtual_screen_size.h, virtual_screen))
         {
             virtual_screen_ratio = static_cast<float>(m_virtual_screen_size.w) / static_cast<float>(m_virtual_screen_size.h);
         }
     }
 
+    // Record the draw operations of each frame
+    m_renderer->set_deferred(m_is_deferred_rendering_enabled);
+
+    // Profiling zones of the scene loop
+    sdl::sdl_profiler& profiler = m_renderer->get_profiler();
+
     // Scene loop
+    m_is_stop_requested       = false;
     bool exit                 = false;
     auto next_period          = std::chrono::steady_clock::now();
     auto last_fps_computation = std::chrono::steady_clock::now();
     do
     {
+        sdl::sdl_profiler::zone frame_zone(profiler, "frame");
+
         // Compute next period in case of fixed framerate
         next_period += scene_period;
 
         // Handle inputs
-        SDL_Event event;
-        while (SDL_PollEvent(&event) != 0)
         {
-            // Window closing event
-            if ((event.type == SDL_WINDOWEVENT) && (event.window.event == SDL_WINDOWEVENT_CLOSE))
+            sdl::sdl_profiler::zone zone(profiler, "poll_events");
+            SDL_Event               event;
+            while (SDL_PollEvent(&event) != 0)
             {
-                exit = true;
-            }
-            else
-            {
-                // Render event
-                if (event.type == SDL_RENDER_TARGETS_RESET)
+                // Window closing event
+                if ((event.type == SDL_WINDOWEVENT) && (event.window.event == SDL_WINDOWEVENT_CLOSE))
                 {
-                    // Update all widgets
-                    for (auto& widget : m_widgets)
+                    exit = true;
+                }
+                else
+                {
+                    // Render event
+                    if ((event.type == SDL_RENDER_TARGETS_RESET) || (event.type == SDL_RENDER_DEVICE_RESET))
                     {
-                        widget->update_needed();
+                        // The drawing state known by the renderer may be lost
+                        m_renderer->invalidate_state();
+
+                        // Update all widgets
+                        for (auto& widget : m_widgets)
+                        {
+                            widget->update_needed();
+                        }
                     }
                 }
-            }
 
-            // Notify event
-            on_input_event(event);
+                // Notify event
+                on_input_event(event);
+            }
         }
 
         // Cleanup background
-        m_renderer->set_draw_color(m_bg_color);
-        m_renderer->clear();
+        {
+            sdl::sdl_profiler::zone zone(profiler, "clear_background");
+            m_renderer->set_draw_color(m_bg_color);
+            m_renderer->clear();
+        }
 
         // Cleanup virtual screen
-        if (virtual_screen_texture)
+        if (virtual_screen.source)
         {
-            m_renderer->push_texture(virtual_screen_texture);
+            sdl::sdl_profiler::zone zone(profiler, "push_virtual_screen");
+            m_renderer->push_texture(virtual_screen.source);
             m_renderer->set_draw_color(m_virtual_screen_bg_color);
             m_renderer->clear();
         }
 
+        // Upload the textures loaded in background
+        if (m_texture_loader)
+        {
+            sdl::sdl_profiler::zone zone(profiler, "upload_textures");
+            m_texture_loader->upload();
+        }
+
         // Render scene
-        on_render();
+        {
+            sdl::sdl_profiler::zone zone(profiler, "on_render");
+            on_render();
+        }
 
         // Regulate framerate
         if (m_is_fixed_fps)
         {
+            sdl::sdl_profiler::zone zone(profiler, "sleep_until");
             std::this_thread::sleep_until(next_period);
         }
 
@@ -155,19 +195,19 @@ void scene::start()
         // Displaye famerate
         if (m_is_fps_display_enabled)
         {
-            std::stringstream ss;
-            ss << std::setw(6) << std::setprecision(1) << std::fixed << m_fps << " FPS";
-            fps_label.set_text(ss.str());
+            sdl::sdl_profiler::zone zone(profiler, "fps_label");
+            fps_label.set_value(m_fps);
             fps_label.render();
         }
 
         // Render virtual screen
-        if (virtual_screen_texture)
+        if (virtual_screen.source)
         {
+            sdl::sdl_profiler::zone zone(profiler, "blit_virtual_screen");
             m_renderer->pop_texture();
             if (m_virtual_screen_fit)
             {
-                m_renderer->copy(virtual_screen_texture, nullptr, nullptr);
+                m_renderer->copy(virtual_screen.source, &virtual_screen.rect, nullptr);
             }
             else
             {
@@ -186,13 +226,20 @@ void scene::start()
                     dst_rect.w = static_cast<int>(static_cast<float>(renderer_height) * virtual_screen_ratio);
                     dst_rect.x = (renderer_width - dst_rect.w) / 2;
                 }
-                m_renderer->copy(virtual_screen_texture, nullptr, &dst_rect);
+                m_renderer->copy(virtual_screen.source, &virtual_screen.rect, &dst_rect);
             }
         }
 
         // Display the scene
-        m_renderer->present();
-    } while (!exit);
+        {
+            sdl::sdl_profiler::zone zone(profiler, "present");
+            m_renderer->present();
+        }
+        on_frame_presented();
+    } while (!exit && !m_is_stop_requested);
+
+    // Back to immediate drawing
+    m_renderer->set_deferred(false);
 }
 
 /** @brief Add a widget to the scene */
@@ -222,6 +269,9 @@ bool scene::remove_widget(widgets::widget& widget)
 /** @brief Called to render the scene */
 void scene::on_render()
 {
+    // Consecutive widgets sharing the same texture are drawn in a single call
+    m_renderer->set_batching(m_is_sprite_batching_enabled);
+
     // Render all the visible widgets
     for (auto& widget : m_widgets)
     {
@@ -230,6 +280,9 @@ void scene::on_render()
             widget->render();
         }
     }
+
+    // Draw the pending widgets
+    m_renderer->set_batching(false);
 }
 
 /** @brief Set the size of the virtual screen (must be called before start()) */
@@ -20,6 +20,7 @@ along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
 #define GAME_SCENE_H
 
 #include "sdl.h"
+#include "sdl_texture_loader.h"
 #include "widget.h"
 
 #include <set>
@@ -48,6 +49,8 @@ class scene
 
     /** @brief Start the scene */
     void start();
+    /** @brief Stop the scene at the end of the current frame */
+    void stop() { m_is_stop_requested = true; }
 
     /** @brief Add a widget to the scene */
     bool add_widget(widgets::widget& widget);
@@ -64,6 +67,9 @@ class scene
     /** @brief Called to render the scene */
     virtual void on_render();
 
+    /** @brief Called once the frame has been presented (its rendering statistics are available) */
+    virtual void on_frame_presented() { }
+
     /** @brief Get the window which displays the scene */
     sdl::window& get_window() { return m_window; }
 
@@ -78,6 +84,29 @@ class scene
     void set_fps_display(bool is_enabled) { m_is_fps_display_enabled = is_enabled; }
     /** @brief Get the current framerate */
     float get_fps() const { return m_fps; }
+    /** @brief Get the rendering statistics of the last displayed frame */
+    const sdl::render_stats& get_render_stats() const { return m_renderer->get_render_stats(); }
+
+    /** @brief Enable/disable the profiling of the scene loop (can be changed while the scene is running) */
+    void set_profiling(bool is_enabled) { m_renderer->get_profiler().set_enabled(is_enabled); }
+    /** @brief Save the last profiled frames as a Chrome trace JSON file */
+    bool save_profile(const std::string& file) { return m_renderer->get_profiler().save(file); }
+
+    /** @brief Set the asynchronous texture loader whose decoded images are uploaded at each frame before rendering */
+    void set_texture_loader(const sdl::texture_loader& loader) { m_texture_loader = loader; }
+    /** @brief Get the asynchronous texture loader */
+    const sdl::texture_loader& get_texture_loader() const { return m_texture_loader; }
+
+    /** @brief Enable/disable the batching of the widgets drawing (enabled by default) */
+    void set_sprite_batching(bool is_enabled) { m_is_sprite_batching_enabled = is_enabled; }
+    /** @brief Indicate if the batching of the widgets drawing is enabled */
+    bool is_sprite_batching() const { return m_is_sprite_batching_enabled; }
+
+    /** @brief Enable/disable the deferred rendering: draw operations are recorded during the frame, then sorted
+     *         by target, layer and texture before being drawn (must be called before start()) */
+    void set_deferred_rendering(bool is_enabled) { m_is_deferred_rendering_enabled = is_enabled; }
+    /** @brief Indicate if the deferred rendering is enabled */
+    bool is_deferred_rendering() const { return m_is_deferred_rendering_enabled; }
 
     // Virtual screen allow to resize rendering automatically to the actual window's size
     // This functions must be called before starting the scene
@@ -108,6 +137,12 @@ class scene
     float m_fps;
     /** @brief Indicate if the current framerate must be displayed */
     bool m_is_fps_display_enabled;
+    /** @brief Indicate if the batching of the widgets drawing is enabled */
+    bool m_is_sprite_batching_enabled;
+    /** @brief Indicate if the deferred rendering is enabled */
+    bool m_is_deferred_rendering_enabled;
+    /** @brief Asynchronous texture loader */
+    sdl::texture_loader m_texture_loader;
     /** @brief Indicate if the virtual screen is enabled */
     bool m_is_virtual_screen_enabled;
     /** @brief Indicate if the rendering of the virtual screen must fit the window */
@@ -117,6 +152,9 @@ class scene
     /** @brief Background color of the virtual screen */
     SDL_Color m_virtual_screen_bg_color;
 
+    /** @brief Indicate if the scene must be stopped */
+    bool m_is_stop_requested;
+
     /** @brief Widgets cmopsing the scene */
     std::set<widgets::widget*> m_widgets;
 };
@@ -0,0 +1,108 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAME_SPRITE_BUNDLE_H
+#define GAME_SPRITE_BUNDLE_H
+
+#include <SDL2/SDL.h>
+
+namespace game
+{
+
+/** @brief Binary sprite bundle format, all values are stored in the native endianness
+ *
+ *  File layout :
+ *   - bundle_header
+ *   - bundle_animation[animation_count]
+ *   - bundle_frame[frame_count]
+ *   - names (names_size bytes, not null terminated)
+ *   - pixels, starting at pixels_offset, each frame starting on a BUNDLE_ALIGNMENT boundary
+ *
+ *  The frames are trimmed of their fully transparent borders and identical frames share the same pixels,
+ *  so the pixels can be uploaded as is without any processing when loading the bundle
+ */
+
+/** @brief Magic number of a sprite bundle */
+static constexpr char BUNDLE_MAGIC[4] = {'S', 'P', 'R', 'B'};
+/** @brief Version of the sprite bundle format */
+static constexpr Uint32 BUNDLE_VERSION = 2u;
+/** @brief Alignment of the pixels of each frame in the bundle */
+static constexpr Uint64 BUNDLE_ALIGNMENT = 16u;
+
+/** @brief Header of a sprite bundle */
+struct bundle_header
+{
+    /** @brief Magic number */
+    char magic[4];
+    /** @brief Format version */
+    Uint32 version;
+    /** @brief SDL pixel format of the frames */
+    Uint32 pixel_format;
+    /** @brief Number of animations */
+    Uint32 animation_count;
+    /** @brief Total number of frames */
+    Uint32 frame_count;
+    /** @brief Size of the names block in bytes */
+    Uint32 names_size;
+    /** @brief Offset of the pixels block from the start of the file */
+    Uint64 pixels_offset;
+};
+
+/** @brief Animation entry of a sprite bundle */
+struct bundle_animation
+{
+    /** @brief Offset of the name in the names block */
+    Uint32 name_offset;
+    /** @brief Size of the name in bytes */
+    Uint32 name_size;
+    /** @brief Index of the first frame of the animation in the frame entries */
+    Uint32 first_frame;
+    /** @brief Number of frames of the animation */
+    Uint32 frame_count;
+};
+
+/** @brief Frame entry of a sprite bundle */
+struct bundle_frame
+{
+    /** @brief Image number */
+    Uint32 number;
+    /** @brief Width in pixels of the stored pixels */
+    Uint32 width;
+    /** @brief Height in pixels of the stored pixels */
+    Uint32 height;
+    /** @brief Number of bytes in a row of pixels */
+    Uint32 pitch;
+    /** @brief Offset of the pixels from the start of the file, identical frames share the same offset */
+    Uint64 offset;
+    /** @brief Horizontal position of the stored pixels in the untrimmed frame */
+    Uint32 x;
+    /** @brief Vertical position of the stored pixels in the untrimmed frame */
+    Uint32 y;
+    /** @brief Width in pixels of the untrimmed frame */
+    Uint32 frame_width;
+    /** @brief Height in pixels of the untrimmed frame */
+    Uint32 frame_height;
+};
+
+static_assert(sizeof(bundle_header) == 32u, "Unexpected padding in bundle_header");
+static_assert(sizeof(bundle_animation) == 16u, "Unexpected padding in bundle_animation");
+static_assert(sizeof(bundle_frame) == 40u, "Unexpected padding in bundle_frame");
+
+} // namespace game
+
+#endif // GAME_SPRITE_BUNDLE_H
@@ -17,34 +17,266 @@ along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "sprites_db.h"
+#include "sdl_mapped_file.h"
+#include "sprite_bundle.h"
 
+#include <algorithm>
+#include <climits>
+#include <cstring>
 #include <filesystem>
 
 namespace game
 {
 
 /** @brief Constructor */
-sprites_db::sprites_db(sdl::renderer& renderer) : m_renderer(renderer), m_animations() { }
+sprites_db::sprites_db(sdl::renderer& renderer, int atlas_page_size, size_t thread_count)
+    : m_renderer(renderer),
+      m_atlas(sdl::create_texture_atlas(renderer, atlas_page_size, atlas_page_size)),
+      m_animations(),
+      m_frames(),
+      m_frame_count(0),
+      m_unique_frame_count(0),
+      m_saved_bytes(0),
+      m_lifetime_token(std::make_shared<bool>(true)),
+      m_loader(sdl::create_texture_loader(renderer, thread_count))
+{
+}
 
 /** @brief Load an animation from a path */
 bool sprites_db::load_animation(const std::string& name, const std::string& path, const std::string& base_name)
 {
-    // Build corresponding regex
-    std::string regex_str = base_name + "_([0-9]+)\\..*";
-    std::regex  regex(regex_str.c_str());
-
-    // Load animation
-    return load_animation(name, path, regex, 0);
+    return load_animation(name, path, build_filter(base_name), 0);
 }
 
 /** @brief Load an animation from a path */
 bool sprites_db::load_animation(const std::string& name, const std::string& path, const std::regex& filter, unsigned int capture_group)
 {
-    bool                ret = true;
-    widgets::image_list animation;
+    bool                    ret = false;
+    std::vector<frame_file> frames;
+    if (m_loader && list_frames(path, filter, capture_group, frames))
+    {
+        // Decode all the images in parallel
+        std::vector<std::shared_future<sdl::surface>> images;
+        for (const auto& frame : frames)
+        {
+            images.push_back(m_loader->decode(frame.file));
+        }
+
+        // Upload them in order
+        widgets::image_list animation;
+        ret = true;
+        for (size_t i = 0; ret && (i < frames.size()); i++)
+        {
+            auto part = std::make_shared<widgets::image>(m_renderer);
+            ret       = load_image(*part, images[i].get());
+            if (ret)
+            {
+                animation.emplace_back(frames[i].number, std::move(part));
+            }
+        }
+        if (ret)
+        {
+            // Save animation
+            m_animations[name] = std::move(animation);
+        }
+    }
+
+    return ret;
+}
+
+/** @brief Load a batch of animations in background */
+bool sprites_db::load_animations(const std::vector<animation_source>& animations, load_handler handler)
+{
+    bool ret = (m_loader != nullptr);
+    if (ret)
+    {
+        auto batch = std::make_shared<pending_batch>();
+        batch->animations.resize(animations.size());
+        batch->is_ok = true;
+
+        std::weak_ptr<bool> token = m_lifetime_token;
+        for (size_t i = 0; ret && (i < animations.size()); i++)
+        {
+            const animation_source& source = animations[i];
+
+            // Decode the images in background and pack them into the atlas in order
+            std::vector<frame_file> frames;
+            ret = list_frames(source.path, build_filter(source.base_name), 0, frames);
+            if (ret)
+            {
+                batch->names.push_back(source.name);
+                for (const auto& frame : frames)
+                {
+                    int number = frame.number;
+                    m_loader->load(frame.file,
+                                   [this, token, batch, i, number](const sdl::surface& image)
+                                   {
+                                       if (!token.expired())
+                                       {
+                                           auto part = std::make_shared<widgets::image>(m_renderer);
+                                           if (load_image(*part, image))
+                                           {
+                                               batch->animations[i].emplace_back(number, std::move(part));
+                                           }
+                                           else
+                                           {
+                                               batch->is_ok = false;
+                                           }
+                                       }
+                                   });
+                }
+            }
+        }
+
+        // Save the animations once all the submitted images have been processed,
+        // the handler is notified even if an animation could not be found
+        bool is_complete = ret;
+        m_loader->post(
+            [this, token, batch, handler, is_complete](const sdl::surface&)
+            {
+                bool success = !token.expired();
+                if (success)
+                {
+                    for (size_t i = 0; i < batch->names.size(); i++)
+                    {
+                        m_animations[batch->names[i]] = std::move(batch->animations[i]);
+                    }
+                    success = (batch->is_ok && is_complete);
+                }
+                if (handler)
+                {
+                    handler(success);
+                }
+            });
+    }
+    else if (handler)
+    {
+        handler(false);
+    }
+
+    return ret;
+}
+
+/** @brief Load all the animations of a sprite bundle */
+bool sprites_db::load_bundle(const std::string& file)
+{
+    bool ret = false;
+
+    sdl::mapped_file bundle = sdl::map_file(file);
+    if (bundle && (bundle->get_size() >= sizeof(bundle_header)))
+    {
+        // Check header
+        const Uint8*         data   = bundle->get_data();
+        Uint64               size   = bundle->get_size();
+        const bundle_header* header = reinterpret_cast<const bundle_header*>(data);
+        Uint64               tables = sizeof(bundle_header) + static_cast<Uint64>(header->animation_count) * sizeof(bundle_animation) +
+                        static_cast<Uint64>(header->frame_count) * sizeof(bundle_frame) + header->names_size;
+        ret = ((std::memcmp(header->magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) == 0) && (header->version == BUNDLE_VERSION) &&
+               (tables <= size));
+        if (ret)
+        {
+            const bundle_animation* animations = reinterpret_cast<const bundle_animation*>(data + sizeof(bundle_header));
+            const bundle_frame*     frames     = reinterpret_cast<const bundle_frame*>(animations + header->animation_count);
+            const char*             names      = reinterpret_cast<const char*>(frames + header->frame_count);
+
+            // Identical frames share the same pixels in the bundle, each pixels are uploaded once
+            std::unordered_map<Uint64, sdl::texture_region> regions;
+            for (Uint32 i = 0; ret && (i < header->animation_count); i++)
+            {
+                // Check animation entry
+                const bundle_animation& anim = animations[i];
+                ret = ((static_cast<Uint64>(anim.name_offset) + anim.name_size <= header->names_size) &&
+                       (static_cast<Uint64>(anim.first_frame) + anim.frame_count <= header->frame_count) && (anim.frame_count != 0));
+
+                // Create the images from the mapped pixels
+                widgets::image_list animation;
+                for (Uint32 j = 0; ret && (j < anim.frame_count); j++)
+                {
+                    // Each term is checked separately in 64 bits so that a malformed entry cannot wrap around
+                    const bundle_frame& frame = frames[anim.first_frame + j];
+                    Uint64              row   = static_cast<Uint64>(frame.width) * SDL_BYTESPERPIXEL(header->pixel_format);
+                    ret = ((frame.width != 0) && (frame.height != 0) && (frame.frame_width <= INT_MAX) && (frame.frame_height <= INT_MAX) &&
+                           ((static_cast<Uint64>(frame.x) + frame.width) <= frame.frame_width) &&
+                           ((static_cast<Uint64>(frame.y) + frame.height) <= frame.frame_height) && (frame.pitch <= INT_MAX) &&
+                           (row <= frame.pitch) && ((frame.offset % BUNDLE_ALIGNMENT) == 0) && (frame.offset <= size) &&
+                           ((static_cast<Uint64>(frame.pitch) * frame.height) <= (size - frame.offset)));
+                    if (ret)
+                    {
+                        // Upload the pixels straight from the mapping the first time they are used
+                        sdl::texture_region region;
+                        auto                iter_region = regions.find(frame.offset);
+                        if (iter_region != regions.end())
+                        {
+                            // Frames sharing pixels must have the same size
+                            region = iter_region->second;
+                            ret    = ((static_cast<Uint32>(region.rect.w) == frame.width) &&
+                                      (static_cast<Uint32>(region.rect.h) == frame.height));
+                            m_saved_bytes += row * frame.height;
+                        }
+                        else
+                        {
+                            ret = store_pixels(data + frame.offset,
+                                               static_cast<int>(frame.pitch),
+                                               static_cast<int>(frame.width),
+                                               static_cast<int>(frame.height),
+                                               header->pixel_format,
+                                               region);
+                            if (ret)
+                            {
+                                regions[frame.offset] = region;
+                                m_unique_frame_count++;
+                            }
+                        }
+                        m_frame_count++;
+
+                        SDL_Rect untrimmed = {static_cast<int>(frame.x),
+                                              static_cast<int>(frame.y),
+                                              static_cast<int>(frame.frame_width),
+                                              static_cast<int>(frame.frame_height)};
+                        auto     part      = std::make_shared<widgets::image>(m_renderer);
+                        ret                = ret && part->load(region, untrimmed);
+                        if (ret)
+                        {
+                            animation.emplace_back(frame.number, std::move(part));
+                        }
+                    }
+                }
+                if (ret)
+                {
+                    m_animations[std::string(names + anim.name_offset, anim.name_size)] = std::move(animation);
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+/** @brief Get an animation */
+const widgets::image_list* sprites_db::get(const std::string& name)
+{
+    const widgets::image_list* anim      = nullptr;
+    auto                       iter_anim = m_animations.find(name);
+    if (iter_anim != m_animations.end())
+    {
+        anim = &iter_anim->second;
+    }
+    return anim;
+}
+
+/** @brief Build the regex filter matching the images of an animation */
+std::regex sprites_db::build_filter(const std::string& base_name)
+{
+    std::string regex_str = base_name + "_([0-9]+)\\..*";
+    return std::regex(regex_str.c_str());
+}
 
+/** @brief List the images of an animation sorted by number */
+bool sprites_db::list_frames(const std::string& path, const std::regex& filter, unsigned int capture_group, std::vector<frame_file>& frames)
+{
     // Browse directory
-    for (const auto& dir_entry : std::filesystem::directory_iterator(std::filesystem::path(path)))
+    std::error_code ec;
+    for (const auto& dir_entry : std::filesystem::directory_iterator(std::filesystem::path(path), ec))
     {
         // Apply filter
         std::smatch match;
@@ -57,40 +289,207 @@ bool sprites_db::load_animation(const std::string& name, const std::string& path
                 // Extract number
                 std::string img_number = match[capture_group + 1].str();
                 int         number     = std::atoi(img_number.c_str());
+                frames.push_back({number, dir_entry.path().string()});
+            }
+        }
+    }
 
-                // Load image
-                auto part = std::make_unique<widgets::image>(m_renderer);
-                ret       = ret && part->load(dir_entry.path().string());
-                if (ret)
+    // Sort animation
+    std::sort(frames.begin(), frames.end(), [](const frame_file& a, const frame_file& b) { return (a.number < b.number); });
+
+    return !frames.empty();
+}
+
+/** @brief Compute the smallest area of an image containing all its non transparent pixels */
+SDL_Rect sprites_db::get_opaque_bounds(const void* pixels, int pitch, int w, int h, Uint32 format)
+{
+    SDL_Rect bounds = {0, 0, w, h};
+
+    // Only the 32 bits formats with an alpha channel are trimmed
+    int    bpp    = 0;
+    Uint32 r_mask = 0;
+    Uint32 g_mask = 0;
+    Uint32 b_mask = 0;
+    Uint32 a_mask = 0;
+    if (SDL_PixelFormatEnumToMasks(format, &bpp, &r_mask, &g_mask, &b_mask, &a_mask) && (bpp == 32) && (a_mask != 0u))
+    {
+        int          min_x = w;
+        int          max_x = -1;
+        int          min_y = h;
+        int          max_y = -1;
+        const Uint8* row   = static_cast<const Uint8*>(pixels);
+        for (int y = 0; y < h; y++, row += pitch)
+        {
+            // Look for the first non transparent pixel of the row
+            const Uint32* line = reinterpret_cast<const Uint32*>(row);
+            int           x    = 0;
+            while ((x < w) && ((line[x] & a_mask) == 0u))
+            {
+                x++;
+            }
+            if (x < w)
+            {
+                // Look for the last non transparent pixel, only outside the current bounds
+                int last = w - 1;
+                while ((last > max_x) && ((line[last] & a_mask) == 0u))
                 {
-                    animation.emplace_back(number, std::move(part));
+                    last--;
                 }
+                min_x = std::min(min_x, x);
+                max_x = std::max(max_x, last);
+                min_y = std::min(min_y, y);
+                max_y = y;
             }
         }
+        if (max_y >= 0)
+        {
+            bounds = {min_x, min_y, max_x - min_x + 1, max_y - min_y + 1};
+        }
+        else
+        {
+            // Fully transparent image, keep a single pixel
+            bounds = {0, 0, 1, 1};
+        }
     }
-    ret = ret && !animation.empty();
-    if (ret)
+
+    return bounds;
+}
+
+/** @brief Compute a 128 bits hash of the rows of an image */
+sprites_db::frame_hash sprites_db::hash_pixels(const void* pixels, int pitch, int row_size, int h, Uint64 seed)
+{
+    // Two independent multiply-rotate lanes using the 64 bits primes of xxHash (this is not XXH128), the images are
+    // not compared afterwards: with 128 bits the probability of a collision is negligible for the images of a game
+    static constexpr Uint64 PRIME_1   = 0x9E3779B185EBCA87ull;
+    static constexpr Uint64 PRIME_2   = 0xC2B2AE3D27D4EB4Full;
+    static constexpr Uint64 PRIME_3   = 0x165667B19E3779F9ull;
+    static constexpr Uint64 PRIME_4   = 0x85EBCA77C2B2AE63ull;
+    static constexpr Uint64 PRIME_5   = 0x27D4EB2F165667C5ull;
+    auto                    rotl      = [](Uint64 value, int bits) { return ((value << bits) | (value >> (64 - bits))); };
+    auto                    avalanche = [](Uint64 value)
     {
-        // Sort animation
-        animation.sort([](const widgets::image_anim& a, const widgets::image_anim& b) { return (a.first < b.first); });
+        value ^= value >> 33;
+        value *= PRIME_2;
+        value ^= value >> 29;
+        value *= PRIME_3;
+        value ^= value >> 32;
+        return value;
+    };
 
-        // Save animation
-        m_animations[name] = std::move(animation);
+    Uint64       low  = seed + PRIME_3;
+    Uint64       high = seed + PRIME_5;
+    const Uint8* row  = static_cast<const Uint8*>(pixels);
+    for (int y = 0; y < h; y++, row += pitch)
+    {
+        // 8 bytes lanes
+        int x = 0;
+        for (; (x + 8) <= row_size; x += 8)
+        {
+            Uint64 lane;
+            std::memcpy(&lane, row + x, sizeof(lane));
+            low ^= rotl(lane * PRIME_2, 31) * PRIME_1;
+            low = rotl(low, 27) * PRIME_1 + PRIME_3;
+            high ^= rotl(lane * PRIME_4, 29) * PRIME_5;
+            high = rotl(high, 23) * PRIME_4 + PRIME_1;
+        }
+
+        // Remaining bytes
+        for (; x < row_size; x++)
+        {
+            low ^= static_cast<Uint64>(row[x]) * PRIME_3;
+            low = rotl(low, 11) * PRIME_1;
+            high ^= static_cast<Uint64>(row[x]) * PRIME_5;
+            high = rotl(high, 13) * PRIME_4;
+        }
     }
 
+    // Final avalanche, each half depends on both lanes
+    low  = avalanche(low);
+    high = avalanche(high);
+    return {low ^ rotl(high, 32), high + low * PRIME_1};
+}
+
+/** @brief Store pixels into the texture atlas, or into a dedicated texture if the atlas cannot store them */
+bool sprites_db::store_pixels(const void* pixels, int pitch, int w, int h, Uint32 format, sdl::texture_region& region)
+{
+    bool ret = false;
+    if (m_atlas && (m_atlas->get_format() == format))
+    {
+        // Pack the image into the atlas
+        ret = m_atlas->add(pixels, pitch, w, h, region);
+    }
+    else
+    {
+        // No compatible atlas available, use a dedicated texture
+        region.source = m_renderer->create_texture(format, SDL_TEXTUREACCESS_STATIC, w, h);
+        ret           = (region.source && region.source->update(nullptr, pixels, pitch));
+        if (ret)
+        {
+            region.source->set_blend_mode(SDL_BLENDMODE_BLEND);
+            region.rect = {0, 0, w, h};
+        }
+    }
     return ret;
 }
 
-/** @brief Get an animation */
-const widgets::image_list* sprites_db::get(const std::string& name)
+/** @brief Load an image into the texture atlas */
+bool sprites_db::load_image(widgets::image& img, const sdl::surface& image)
 {
-    const widgets::image_list* anim      = nullptr;
-    auto                       iter_anim = m_animations.find(name);
-    if (iter_anim != m_animations.end())
+    bool ret = false;
+    if (image)
     {
-        anim = &iter_anim->second;
+        // Convert the image to the format of the atlas
+        sdl::surface source = image;
+        if (m_atlas && (image->get_pixel_format()->format != m_atlas->get_format()))
+        {
+            source = image->convert(m_atlas->get_format());
+        }
+        if (source)
+        {
+            SDL_Rect size = source->get_size();
+            ret = load_image(img, source->get_pixels(), source->get_pitch(), size.w, size.h, source->get_pixel_format()->format);
+        }
     }
-    return anim;
+    return ret;
+}
+
+/** @brief Load raw pixels into the texture atlas */
+bool sprites_db::load_image(widgets::image& img, const void* pixels, int pitch, int w, int h, Uint32 format)
+{
+    // Keep only the non transparent area of the image
+    int          bpp     = SDL_BYTESPERPIXEL(format);
+    SDL_Rect     bounds  = get_opaque_bounds(pixels, pitch, w, h, format);
+    const Uint8* trimmed = static_cast<const Uint8*>(pixels) + bounds.y * pitch + bounds.x * bpp;
+
+    // Hash the non transparent area to look for an identical image already loaded
+    int        geometry[] = {bounds.w, bounds.h};
+    frame_hash seed       = hash_pixels(geometry, sizeof(geometry), sizeof(geometry), 1, format);
+    frame_hash hash       = hash_pixels(trimmed, pitch, bounds.w * bpp, bounds.h, seed.low ^ seed.high);
+
+    bool                ret = false;
+    sdl::texture_region region;
+    auto                iter_frame = m_frames.find(hash);
+    if (iter_frame != m_frames.end())
+    {
+        // Share the existing image
+        region = iter_frame->second;
+        m_saved_bytes += static_cast<Uint64>(bounds.w) * static_cast<Uint64>(bounds.h) * static_cast<Uint64>(bpp);
+        ret = true;
+    }
+    else
+    {
+        ret = store_pixels(trimmed, pitch, bounds.w, bounds.h, format, region);
+        if (ret)
+        {
+            // Only the region is kept, the pixels are identified by their hash
+            m_frames[hash] = region;
+            m_unique_frame_count++;
+        }
+    }
+    m_frame_count++;
+
+    ret = ret && img.load(region, SDL_Rect{bounds.x, bounds.y, w, h});
+    return ret;
 }
 
 } // namespace game
@@ -19,21 +19,49 @@ along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
 #ifndef GAME_ANIMATIONS_DB_H
 #define GAME_ANIMATIONS_DB_H
 
+#include <functional>
+#include <memory>
 #include <regex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
+#include "sdl_texture_atlas.h"
+#include "sdl_texture_loader.h"
 #include "sprite.h"
 
 namespace game
 {
 
-/** @brief Sprite animations database to avoid reloading the same images multiple times */
+/** @brief Sprite animations database to avoid reloading the same images multiple times
+ *         The images of all the animations are packed into a shared texture atlas
+ *         and are decoded in parallel by a pool of worker threads.
+ *         The fully transparent borders of the images are trimmed before being packed
+ *         and identical images, found with a 128 bits hash of their pixels, share the same region of the atlas */
 class sprites_db
 {
   public:
-    /** @brief Constructor */
-    sprites_db(sdl::renderer& renderer);
+    /** @brief Description of an animation to load */
+    struct animation_source
+    {
+        /** @brief Name of the animation */
+        std::string name;
+        /** @brief Path where the images composing the animation are stored */
+        std::string path;
+        /** @brief Base name for the image */
+        std::string base_name;
+    };
+
+    /** @brief Handler called when a batch of animations has been loaded */
+    using load_handler = std::function<void(bool success)>;
+
+    /** 
+     * @brief Constructor 
+     * @param renderer Renderer to use to load the images
+     * @param atlas_page_size Size in pixels of the pages of the texture atlas
+     * @param thread_count Number of image decoding threads (0 to use the number of available cores)
+     */
+    sprites_db(sdl::renderer& renderer, int atlas_page_size = 2048, size_t thread_count = 0);
 
     /** 
      * @brief Load an animation from a path 
@@ -54,6 +82,26 @@ class sprites_db
      */
     bool load_animation(const std::string& name, const std::string& path, const std::regex& filter, unsigned int capture_group = 0);
 
+    /**
+     * @brief Load a batch of animations in background
+     *        The images are decoded by the loader threads and uploaded in order by the upload() method
+     *        of the loader (see get_loader()) which must be called on the rendering thread (ex: by a scene)
+     * @param animations Animations to load
+     * @param handler Handler called by the loader once all the submitted animations have been processed,
+     *                with a failure status if an animation could not be found or loaded
+     * @return true if all the animations have been found and submitted, false otherwise
+     */
+    bool load_animations(const std::vector<animation_source>& animations, load_handler handler);
+
+    /**
+     * @brief Load all the animations of a sprite bundle (see sprite_bundle.h)
+     *        The file is memory mapped and the textures are created directly from the mapped pixels,
+     *        the frames are already trimmed and shared by the cooker so they are not hashed nor copied
+     * @param file Path to the bundle file
+     * @return true if the animations have been loaded, false otherwise
+     */
+    bool load_bundle(const std::string& file);
+
     /**
      * @brief Get an animation
      * @param name Name of the animation
@@ -61,11 +109,91 @@ class sprites_db
      */
     const widgets::image_list* get(const std::string& name);
 
+    /** @brief Get the texture atlas storing the images of the animations */
+    const sdl::texture_atlas& get_atlas() const { return m_atlas; }
+    /** @brief Get the loader decoding the images of the animations */
+    const sdl::texture_loader& get_loader() const { return m_loader; }
+
+    /** @brief Get the number of images loaded */
+    size_t get_frame_count() const { return m_frame_count; }
+    /** @brief Get the number of unique images stored in the atlas */
+    size_t get_unique_frame_count() const { return m_unique_frame_count; }
+    /** @brief Get the number of bytes of texture memory saved by sharing identical images */
+    Uint64 get_saved_bytes() const { return m_saved_bytes; }
+
   private:
+    /** @brief Image file of an animation */
+    struct frame_file
+    {
+        /** @brief Image number */
+        int number;
+        /** @brief Path to the file */
+        std::string file;
+    };
+
+    /** @brief 128 bits hash of the pixels of an image, its size and its pixel format */
+    struct frame_hash
+    {
+        /** @brief Low 64 bits */
+        Uint64 low;
+        /** @brief High 64 bits */
+        Uint64 high;
+
+        /** @brief Comparison operator */
+        bool operator==(const frame_hash& other) const { return ((low == other.low) && (high == other.high)); }
+    };
+
+    /** @brief Hash of a frame hash for the unordered containers */
+    struct frame_hash_hash
+    {
+        /** @brief Compute the hash of a frame hash */
+        size_t operator()(const frame_hash& hash) const { return static_cast<size_t>(hash.low); }
+    };
+
+    /** @brief Animations being loaded in background */
+    struct pending_batch
+    {
+        /** @brief Names of the animations */
+        std::vector<std::string> names;
+        /** @brief Loaded images of the animations */
+        std::vector<widgets::image_list> animations;
+        /** @brief Indicate if all the images have been loaded */
+        bool is_ok;
+    };
+
     /** @brief Renderer to use to load the images */
     sdl::renderer& m_renderer;
+    /** @brief Texture atlas storing the images of the animations */
+    sdl::texture_atlas m_atlas;
     /** @brief Loaded animations */
     std::unordered_map<std::string, widgets::image_list> m_animations;
+    /** @brief Regions of the unique images stored in the atlas indexed by the hash of their pixels */
+    std::unordered_map<frame_hash, sdl::texture_region, frame_hash_hash> m_frames;
+    /** @brief Number of images loaded */
+    size_t m_frame_count;
+    /** @brief Number of unique images stored in the atlas */
+    size_t m_unique_frame_count;
+    /** @brief Number of bytes of texture memory saved by sharing identical images */
+    Uint64 m_saved_bytes;
+    /** @brief Token allowing the loader handlers to detect the destruction of the database */
+    std::shared_ptr<bool> m_lifetime_token;
+    /** @brief Loader decoding the images of the animations */
+    sdl::texture_loader m_loader;
+
+    /** @brief Build the regex filter matching the images of an animation */
+    static std::regex build_filter(const std::string& base_name);
+    /** @brief List the images of an animation sorted by number */
+    static bool list_frames(const std::string& path, const std::regex& filter, unsigned int capture_group, std::vector<frame_file>& frames);
+    /** @brief Compute the smallest area of an image containing all its non transparent pixels */
+    static SDL_Rect get_opaque_bounds(const void* pixels, int pitch, int w, int h, Uint32 format);
+    /** @brief Compute a 128 bits hash of the rows of an image */
+    static frame_hash hash_pixels(const void* pixels, int pitch, int row_size, int h, Uint64 seed);
+    /** @brief Store pixels into the texture atlas, or into a dedicated texture if the atlas cannot store them */
+    bool store_pixels(const void* pixels, int pitch, int w, int h, Uint32 format, sdl::texture_region& region);
+    /** @brief Load an image into the texture atlas */
+    bool load_image(widgets::image& img, const sdl::surface& image);
+    /** @brief Load raw pixels into the texture atlas */
+    bool load_image(widgets::image& img, const void* pixels, int pitch, int w, int h, Uint32 format);
 };
 
 } // namespace game
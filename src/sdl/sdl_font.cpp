@@ -17,6 +17,10 @@ along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "sdl_font.h"
+#include "sdl_text_cache.h"
+
+#include <algorithm>
+#include <cmath>
 
 namespace sdl
 {
@@ -27,6 +31,12 @@ font create_font(const std::string& file, int ptsize)
     return sdl_font::create_font(file, ptsize);
 }
 
+/** @brief Create a font from a file mapped in memory */
+font create_font(const mapped_file& file, int ptsize)
+{
+    return sdl_font::create_font(file, ptsize);
+}
+
 /** @brief Create a font */
 font sdl_font::create_font(const std::string& file, int ptsize)
 {
@@ -34,20 +44,50 @@ font sdl_font::create_font(const std::string& file, int ptsize)
     TTF_Font* font = TTF_OpenFont(file.c_str(), ptsize);
     if (font)
     {
-        auto p = new sdl_font(font);
+        auto p = new sdl_font(font, nullptr);
         instance.reset(p);
     }
     return instance;
 }
 
+/** @brief Create a font from a file mapped in memory */
+font sdl_font::create_font(const mapped_file& file, int ptsize)
+{
+    font instance;
+    if (file)
+    {
+        // The font reads its glyphs from the mapping as long as it is opened
+        SDL_RWops* rw = SDL_RWFromConstMem(file->get_data(), static_cast<int>(file->get_size()));
+        if (rw)
+        {
+            TTF_Font* font = TTF_OpenFontRW(rw, 1, ptsize);
+            if (font)
+            {
+                auto p = new sdl_font(font, file);
+                instance.reset(p);
+            }
+        }
+    }
+    return instance;
+}
+
 /** @brief Destructor */
 sdl_font::~sdl_font()
 {
+    // Textures must not be found anymore if a new font is created at the same address
+    auto cache = m_text_cache.lock();
+    if (cache)
+    {
+        cache->remove(this);
+    }
     TTF_CloseFont(m_handle);
 }
 
 /** @brief Constructor */
-sdl_font::sdl_font(TTF_Font* handle) : m_handle(handle) { }
+sdl_font::sdl_font(TTF_Font* handle, const mapped_file& file)
+    : m_handle(handle), m_file(file), m_text_cache(), m_advances(), m_kernings(), m_lines(), m_lines_index()
+{
+}
 
 /** @brief Create a surface with a text written with the font */
 surface sdl_font::render_solid(const std::string& text, const SDL_Color& fg_color) const
@@ -90,9 +130,44 @@ surface sdl_font::render_blended(const std::string& text, const SDL_Color& fg_co
 
 /** @brief Create a surface with a text written with the font  with wrapping */
 surface sdl_font::render_blended_wrapped(const std::string& text, const SDL_Color& fg_color, Uint32 wrap_length) const
+{
+    // Render each line of the cached line breaks
+    surface              instance;
+    std::vector<surface> lines;
+    int                  width = 0;
+    for (const auto& line : *break_lines(text, wrap_length))
+    {
+        lines.push_back((line.size != 0u) ? render_blended(text.substr(line.first, line.size), fg_color) : nullptr);
+        if (lines.back())
+        {
+            width = std::max(width, lines.back()->get_size().w);
+        }
+    }
+
+    // Stack them on a transparent surface
+    if (width > 0)
+    {
+        int line_skip = get_line_skip();
+        int height    = get_height() + static_cast<int>(lines.size() - 1u) * line_skip;
+        instance      = create_surface(width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+        for (size_t i = 0; instance && (i < lines.size()); i++)
+        {
+            if (lines[i])
+            {
+                SDL_Rect dest = {0, static_cast<int>(i) * line_skip, 0, 0};
+                lines[i]->set_blend_mod(SDL_BLENDMODE_NONE);
+                instance->blit(lines[i], nullptr, &dest);
+            }
+        }
+    }
+    return instance;
+}
+
+/** @brief Create a surface with a single glyph written with the font */
+surface sdl_font::render_glyph_blended(Uint32 ch, const SDL_Color& fg_color) const
 {
     surface      instance;
-    SDL_Surface* surface = TTF_RenderUTF8_Blended_Wrapped(m_handle, text.c_str(), fg_color, wrap_length);
+    SDL_Surface* surface = TTF_RenderGlyph32_Blended(m_handle, ch, fg_color);
     if (surface)
     {
         auto p = new sdl_surface(surface);
@@ -101,4 +176,339 @@ surface sdl_font::render_blended_wrapped(const std::string& text, const SDL_Colo
     return instance;
 }
 
+/** @brief Compute the signed distance field of a single glyph */
+bool sdl_font::render_glyph_sdf(Uint32 ch, int spread, std::vector<Uint8>& distances, int& w, int& h) const
+{
+    bool    ret   = false;
+    surface image = render_glyph_blended(ch, SDL_Color{255, 255, 255, 255});
+    if (image && (image->get_pixel_format()->BytesPerPixel == 4u) && (image->get_pixel_format()->Amask != 0u))
+    {
+        // Split the glyph into inside and outside pixels using its coverage
+        static constexpr float FAR_AWAY = 1e20f;
+
+        const SDL_PixelFormat* format = image->get_pixel_format();
+        SDL_Rect               size   = image->get_size();
+        w                             = size.w + 2 * spread;
+        h                             = size.h + 2 * spread;
+        std::vector<float> to_inside(static_cast<size_t>(w) * static_cast<size_t>(h), FAR_AWAY);
+        std::vector<float> to_outside(to_inside.size(), 0.f);
+        for (int y = 0; y < size.h; y++)
+        {
+            const Uint32* row = reinterpret_cast<const Uint32*>(static_cast<const Uint8*>(image->get_pixels()) + y * image->get_pitch());
+            for (int x = 0; x < size.w; x++)
+            {
+                Uint32 alpha = ((row[x] & format->Amask) >> format->Ashift);
+                if (alpha >= 128u)
+                {
+                    size_t index      = static_cast<size_t>(y + spread) * static_cast<size_t>(w) + static_cast<size_t>(x + spread);
+                    to_inside[index]  = 0.f;
+                    to_outside[index] = FAR_AWAY;
+                }
+            }
+        }
+
+        // Distance of each pixel to the nearest pixel on the other side of the outline
+        compute_squared_edt(to_inside, w, h);
+        compute_squared_edt(to_outside, w, h);
+
+        // The outline lies half a pixel away from the centers of the border pixels
+        float scale = 127.f / static_cast<float>(std::max(spread, 1));
+        distances.resize(to_inside.size());
+        for (size_t i = 0; i < distances.size(); i++)
+        {
+            float distance = ((to_inside[i] == 0.f) ? (std::sqrt(to_outside[i]) - 0.5f) : (0.5f - std::sqrt(to_inside[i])));
+            distances[i]   = static_cast<Uint8>(std::min(std::max(128.f + distance * scale, 0.f), 255.f));
+        }
+        ret = true;
+    }
+    return ret;
+}
+
+/** @brief Compute the squared euclidean distance transform of a grid in place */
+void sdl_font::compute_squared_edt(std::vector<float>& grid, int w, int h)
+{
+    // Separable transform from Felzenszwalb and Huttenlocher: columns first, then rows
+    int                n = std::max(w, h);
+    std::vector<float> f(static_cast<size_t>(n));
+    std::vector<float> d(static_cast<size_t>(n));
+    std::vector<int>   v(static_cast<size_t>(n));
+    std::vector<float> z(static_cast<size_t>(n) + 1u);
+    for (int x = 0; x < w; x++)
+    {
+        for (int y = 0; y < h; y++)
+        {
+            f[y] = grid[static_cast<size_t>(y) * static_cast<size_t>(w) + static_cast<size_t>(x)];
+        }
+        compute_squared_edt(&f[0], &d[0], &v[0], &z[0], h);
+        for (int y = 0; y < h; y++)
+        {
+            grid[static_cast<size_t>(y) * static_cast<size_t>(w) + static_cast<size_t>(x)] = d[y];
+        }
+    }
+    for (int y = 0; y < h; y++)
+    {
+        float* row = &grid[static_cast<size_t>(y) * static_cast<size_t>(w)];
+        std::copy(row, row + w, f.begin());
+        compute_squared_edt(&f[0], row, &v[0], &z[0], w);
+    }
+}
+
+/** @brief Compute the squared distance transform of a sampled function along a line */
+void sdl_font::compute_squared_edt(const float* f, float* d, int* v, float* z, int n)
+{
+    static constexpr float INF = 1e30f;
+
+    // Lower envelope of the parabolas rooted at each sample
+    int k = 0;
+    v[0]  = 0;
+    z[0]  = -INF;
+    z[1]  = INF;
+    for (int q = 1; q < n; q++)
+    {
+        float fq = f[q] + static_cast<float>(q * q);
+        float s  = 0.f;
+        do
+        {
+            int r = v[k];
+            s     = (fq - (f[r] + static_cast<float>(r * r))) / static_cast<float>(2 * (q - r));
+        } while ((s <= z[k]) && (--k >= 0));
+        k++;
+        v[k]     = q;
+        z[k]     = s;
+        z[k + 1] = INF;
+    }
+
+    // Sample the envelope
+    k = 0;
+    for (int q = 0; q < n; q++)
+    {
+        while (z[k + 1] < static_cast<float>(q))
+        {
+            k++;
+        }
+        int r = v[k];
+        d[q]  = static_cast<float>((q - r) * (q - r)) + f[r];
+    }
+}
+
+/** @brief Get the metrics of a glyph */
+bool sdl_font::get_glyph_metrics(Uint32 ch, int& minx, int& maxx, int& miny, int& maxy, int& advance) const
+{
+    return (TTF_GlyphMetrics32(m_handle, ch, &minx, &maxx, &miny, &maxy, &advance) == 0);
+}
+
+/** @brief Get the kerning in pixels between 2 glyphs */
+int sdl_font::get_kerning(Uint32 previous_ch, Uint32 ch) const
+{
+    Uint64 key          = ((static_cast<Uint64>(previous_ch) << 32u) | ch);
+    auto   iter_kerning = m_kernings.find(key);
+    if (iter_kerning == m_kernings.end())
+    {
+        iter_kerning = m_kernings.emplace(key, TTF_GetFontKerningSizeGlyphs32(m_handle, previous_ch, ch)).first;
+    }
+    return iter_kerning->second;
+}
+
+/** @brief Get the horizontal advance in pixels of a glyph */
+int sdl_font::get_advance(Uint32 ch) const
+{
+    auto iter_advance = m_advances.find(ch);
+    if (iter_advance == m_advances.end())
+    {
+        int minx    = 0;
+        int maxx    = 0;
+        int miny    = 0;
+        int maxy    = 0;
+        int advance = 0;
+        if (!get_glyph_metrics(ch, minx, maxx, miny, maxy, advance))
+        {
+            advance = 0;
+        }
+        iter_advance = m_advances.emplace(ch, advance).first;
+    }
+    return iter_advance->second;
+}
+
+/** @brief Get the maximum height of the glyphs */
+int sdl_font::get_height() const
+{
+    return TTF_FontHeight(m_handle);
+}
+
+/** @brief Get the recommended spacing between 2 lines of text */
+int sdl_font::get_line_skip() const
+{
+    return TTF_FontLineSkip(m_handle);
+}
+
+/** @brief Compute the size of a text from the advances of its glyphs, nothing is rasterized */
+SDL_Rect sdl_font::measure(const std::string& text, Uint32 wrap_length) const
+{
+    SDL_Rect size = {0, 0, 0, 0};
+    if (!text.empty())
+    {
+        auto lines = break_lines(text, wrap_length);
+        for (const auto& line : *lines)
+        {
+            size.w = std::max(size.w, line.width);
+        }
+        size.h = get_height() + static_cast<int>(lines->size() - 1u) * get_line_skip();
+    }
+    return size;
+}
+
+/** @brief Break a text into lines, the lines are wrapped between words or inside the words longer than a line */
+std::shared_ptr<const std::vector<text_line>> sdl_font::break_lines(const std::string& text, Uint32 wrap_length) const
+{
+    std::shared_ptr<const std::vector<text_line>> ret;
+
+    // The text of the caller is only referenced during the lookup
+    auto iter = m_lines_index.find({wrap_length, &text});
+    if (iter != m_lines_index.end())
+    {
+        // Move the text at the front of the LRU list
+        m_lines.splice(m_lines.begin(), m_lines, iter->second);
+        ret = iter->second->lines;
+    }
+    else
+    {
+        std::vector<text_line> lines;
+
+        // Current line and last space where it can be broken
+        text_line line           = {0u, 0u, 0};
+        size_t    space_pos      = std::string::npos;
+        size_t    space_next     = 0u;
+        int       width_to_space = 0;
+        int       width_to_word  = 0;
+        Uint32    previous_ch    = 0u;
+        size_t    pos            = 0u;
+        while (pos < text.size())
+        {
+            size_t ch_pos = pos;
+            Uint32 ch     = next_code_point(text, pos);
+            if (ch == '\n')
+            {
+                // Forced break
+                line.size = ch_pos - line.first;
+                lines.push_back(line);
+                line        = {pos, 0u, 0};
+                space_pos   = std::string::npos;
+                previous_ch = 0u;
+            }
+            else
+            {
+                int width = get_advance(ch) + ((previous_ch != 0u) ? get_kerning(previous_ch, ch) : 0);
+                if ((wrap_length != 0u) && (ch != ' ') && (ch_pos > line.first) &&
+                    (static_cast<Uint32>(line.width + width) > wrap_length))
+                {
+                    if (space_pos != std::string::npos)
+                    {
+                        // Break at the last space, the beginning of the current word goes to the next line
+                        int word_width = line.width - width_to_word;
+                        line.size      = space_pos - line.first;
+                        line.width     = width_to_space;
+                        lines.push_back(line);
+                        line = {space_next, 0u, word_width};
+                    }
+                    else
+                    {
+                        // Word longer than a line
+                        line.size = ch_pos - line.first;
+                        lines.push_back(line);
+                        line = {ch_pos, 0u, 0};
+                    }
+                    space_pos = std::string::npos;
+                    width     = get_advance(ch) + ((line.first != ch_pos) ? get_kerning(previous_ch, ch) : 0);
+                }
+                if (ch == ' ')
+                {
+                    space_pos      = ch_pos;
+                    space_next     = pos;
+                    width_to_space = line.width;
+                    width_to_word  = line.width + width;
+                }
+                line.width += width;
+                previous_ch = ch;
+            }
+        }
+        line.size = text.size() - line.first;
+        lines.push_back(line);
+        ret = std::make_shared<const std::vector<text_line>>(std::move(lines));
+
+        // Keep the cache bounded by dropping the least recently used texts
+        if (m_lines.size() >= MAX_CACHED_TEXTS)
+        {
+            m_lines_index.erase({m_lines.back().wrap_length, &m_lines.back().text});
+            m_lines.pop_back();
+        }
+        m_lines.push_front({wrap_length, text, ret});
+        m_lines_index.emplace(lines_key{wrap_length, &m_lines.front().text}, m_lines.begin());
+    }
+    return ret;
+}
+
+/** @brief Comparison operator */
+bool sdl_font::lines_key::operator==(const lines_key& other) const
+{
+    return (wrap_length == other.wrap_length) && (*text == *other.text);
+}
+
+/** @brief Compute the hash of a key */
+size_t sdl_font::lines_key_hash::operator()(const lines_key& k) const
+{
+    size_t hash = std::hash<std::string>()(*k.text);
+    hash ^= std::hash<Uint32>()(k.wrap_length) + 0x9E3779B97F4A7C15ull + (hash << 6u) + (hash >> 2u);
+    return hash;
+}
+
+/** @brief Decode the next code point of an UTF-8 text */
+Uint32 sdl_font::next_code_point(const std::string& text, size_t& pos)
+{
+    static constexpr Uint32 REPLACEMENT_CHARACTER = 0xFFFDu;
+
+    // Number of continuation bytes and bits of the first byte
+    Uint32 ch    = static_cast<Uint8>(text[pos]);
+    size_t count = 0;
+    if (ch >= 0xF0u)
+    {
+        ch    = ch & 0x07u;
+        count = 3u;
+    }
+    else if (ch >= 0xE0u)
+    {
+        ch    = ch & 0x0Fu;
+        count = 2u;
+    }
+    else if (ch >= 0xC0u)
+    {
+        ch    = ch & 0x1Fu;
+        count = 1u;
+    }
+    else if (ch >= 0x80u)
+    {
+        // Unexpected continuation byte
+        ch = REPLACEMENT_CHARACTER;
+    }
+    pos++;
+
+    // Continuation bytes
+    for (size_t i = 0; i < count; i++)
+    {
+        Uint8 byte = ((pos < text.size()) ? static_cast<Uint8>(text[pos]) : 0u);
+        if ((byte & 0xC0u) == 0x80u)
+        {
+            ch = ((ch << 6u) | (byte & 0x3Fu));
+            pos++;
+        }
+        else
+        {
+            // Truncated sequence
+            ch = REPLACEMENT_CHARACTER;
+            break;
+        }
+    }
+
+    return ch;
+}
+
 } // namespace sdl
@@ -20,9 +20,13 @@ along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
 #define SDL_FONT_H
 
 #include <SDL2/SDL_ttf.h>
+#include <list>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
+#include "sdl_mapped_file.h"
 #include "sdl_surface.h"
 
 namespace sdl
@@ -30,6 +34,7 @@ namespace sdl
 
 // Forward declarations
 class sdl_font;
+class sdl_text_cache;
 
 /** @brief SDL font */
 using font = std::shared_ptr<sdl_font>;
@@ -42,6 +47,25 @@ using font = std::shared_ptr<sdl_font>;
  */
 font create_font(const std::string& file, int ptsize);
 
+/**
+ * @brief Create a font from a file mapped in memory
+ * @param file Mapped font file, kept alive as long as the font exists
+ * @param ptsize Point size
+ * @return SDL font object if the creation was successfull, nullptr otherwise
+ */
+font create_font(const mapped_file& file, int ptsize);
+
+/** @brief Line of a text broken to fit a width */
+struct text_line
+{
+    /** @brief Position of the first byte of the line in the text */
+    size_t first;
+    /** @brief Number of bytes of the line, without the separator */
+    size_t size;
+    /** @brief Width of the line in pixels */
+    int width;
+};
+
 /** @brief Wrapper for SDL font */
 class sdl_font
 {
@@ -54,6 +78,14 @@ class sdl_font
      */
     static font create_font(const std::string& file, int ptsize);
 
+    /**
+     * @brief Create a font from a file mapped in memory
+     * @param file Mapped font file, kept alive as long as the font exists
+     * @param ptsize Point size
+     * @return SDL font object if the creation was successfull, nullptr otherwise
+     */
+    static font create_font(const mapped_file& file, int ptsize);
+
     /** @brief Destructor */
     ~sdl_font();
 
@@ -91,15 +123,138 @@ class sdl_font
      */
     surface render_blended_wrapped(const std::string& text, const SDL_Color& fg_color, Uint32 wrap_length) const;
 
+    /**
+     * @brief Create a surface with a single glyph written with the font
+     * @param ch Unicode code point of the glyph
+     * @param fg_color Glyph color
+     * @return SDL surface object if the rendering was successfull, nullptr otherwise
+     */
+    surface render_glyph_blended(Uint32 ch, const SDL_Color& fg_color) const;
+
+    /**
+     * @brief Compute the signed distance field of a single glyph
+     * @param ch Unicode code point of the glyph
+     * @param spread Distance in pixels covered by the field on each side of the outline,
+     *               the glyph is surrounded by an empty border of this size
+     * @param distances Distance of each pixel to the outline: 128 on the outline, 255 at spread pixels inside,
+     *                  0 at spread pixels outside
+     * @param w Width of the field
+     * @param h Height of the field
+     * @return true if the field has been computed, false otherwise (ex: empty glyph)
+     */
+    bool render_glyph_sdf(Uint32 ch, int spread, std::vector<Uint8>& distances, int& w, int& h) const;
+
+    /**
+     * @brief Get the metrics of a glyph
+     * @param ch Unicode code point of the glyph
+     * @param minx Minimum X offset
+     * @param maxx Maximum X offset
+     * @param miny Minimum Y offset
+     * @param maxy Maximum Y offset
+     * @param advance Horizontal advance
+     * @return true if the glyph exists in the font, false otherwise
+     */
+    bool get_glyph_metrics(Uint32 ch, int& minx, int& maxx, int& miny, int& maxy, int& advance) const;
+
+    /** @brief Get the horizontal advance in pixels of a glyph (0 if the glyph is not in the font) */
+    int get_advance(Uint32 ch) const;
+    /** @brief Get the kerning in pixels between 2 glyphs */
+    int get_kerning(Uint32 previous_ch, Uint32 ch) const;
+    /** @brief Get the maximum height of the glyphs */
+    int get_height() const;
+    /** @brief Get the recommended spacing between 2 lines of text */
+    int get_line_skip() const;
+
+    /**
+     * @brief Compute the size of a text from the advances of its glyphs, nothing is rasterized
+     * @param text UTF-8 text, lines are separated by '\n'
+     * @param wrap_length Length in pixel before wrapping (0 to disable wrapping)
+     * @return Size of the text (x and y are always 0)
+     */
+    SDL_Rect measure(const std::string& text, Uint32 wrap_length = 0) const;
+
+    /**
+     * @brief Break a text into lines, the lines are wrapped between words or inside the words longer than a line
+     * @param text UTF-8 text, lines are separated by '\n'
+     * @param wrap_length Length in pixel before wrapping (0 to disable wrapping)
+     * @return Lines of the text, shared with the cache
+     */
+    std::shared_ptr<const std::vector<text_line>> break_lines(const std::string& text, Uint32 wrap_length) const;
+
+    /** @brief Decode the next code point of an UTF-8 text and move to the following one */
+    static Uint32 next_code_point(const std::string& text, size_t& pos);
+
+    /** @brief Set the cache used to store the textures of the texts rendered with the font */
+    void set_text_cache(const std::shared_ptr<sdl_text_cache>& cache) { m_text_cache = cache; }
+    /** @brief Get the cache used to store the textures of the texts rendered with the font (can be nullptr) */
+    std::shared_ptr<sdl_text_cache> get_text_cache() const { return m_text_cache.lock(); }
+
   private:
+    /** @brief Key of the lines of a broken text */
+    struct lines_key
+    {
+        /** @brief Wrap length */
+        Uint32 wrap_length;
+        /** @brief Text, owned by the cached entry or by the caller during a lookup */
+        const std::string* text;
+
+        /** @brief Comparison operator */
+        bool operator==(const lines_key& other) const;
+    };
+
+    /** @brief Hash of the key of the lines of a broken text */
+    struct lines_key_hash
+    {
+        /** @brief Compute the hash of a key */
+        size_t operator()(const lines_key& k) const;
+    };
+
+    /** @brief Lines of a broken text */
+    struct lines_entry
+    {
+        /** @brief Wrap length */
+        Uint32 wrap_length;
+        /** @brief Text */
+        std::string text;
+        /** @brief Lines of the text */
+        std::shared_ptr<const std::vector<text_line>> lines;
+    };
+
     /** @brief SDL handle */
     TTF_Font* m_handle;
+    /** @brief Mapped font file which the font is read from (can be nullptr) */
+    mapped_file m_file;
+    /** @brief Cache of the textures of the texts rendered with the font */
+    std::weak_ptr<sdl_text_cache> m_text_cache;
+    /** @brief Horizontal advances of the glyphs indexed by code point */
+    mutable std::unordered_map<Uint32, int> m_advances;
+    /** @brief Kerning between 2 glyphs indexed by their code points */
+    mutable std::unordered_map<Uint64, int> m_kernings;
+    /** @brief Lines of the broken texts, from the most to the least recently used */
+    mutable std::list<lines_entry> m_lines;
+    /** @brief Lines of the broken texts indexed by wrap length and text */
+    mutable std::unordered_map<lines_key, std::list<lines_entry>::iterator, lines_key_hash> m_lines_index;
+
+    /** @brief Maximum number of broken texts kept in cache */
+    static constexpr size_t MAX_CACHED_TEXTS = 256u;
+
+    /**
+     * @brief Compute the squared euclidean distance transform of a grid in place
+     * @param grid 0 for the feature pixels, a large value for the others
+     * @param w Width of the grid
+     * @param h Height of the grid
+     */
+    static void compute_squared_edt(std::vector<float>& grid, int w, int h);
+
+    /** @brief Compute the squared distance transform of a sampled function along a line */
+    static void compute_squared_edt(const float* f, float* d, int* v, float* z, int n);
 
     /** 
      * @brief Constructor 
      * @param handle SDL handle
+     * @param file Mapped font file which the font is read from (can be nullptr)
      */
-    sdl_font(TTF_Font* handle);
+    sdl_font(TTF_Font* handle, const mapped_file& file);
 };
 
 } // namespace sdl
@@ -0,0 +1,466 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sdl_glyph_atlas.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sdl
+{
+
+/** @brief Create a glyph atlas */
+glyph_atlas create_glyph_atlas(const renderer& renderer, const font& font, int page_size)
+{
+    return sdl_glyph_atlas::create(renderer, font, page_size);
+}
+
+/** @brief Create a glyph atlas storing the signed distance fields of the glyphs */
+glyph_atlas create_sdf_glyph_atlas(const renderer& renderer, const font& font, int spread, int page_size)
+{
+    return sdl_glyph_atlas::create_sdf(renderer, font, spread, page_size);
+}
+
+/** @brief Create a glyph atlas from a pre-rasterized font */
+glyph_atlas create_baked_glyph_atlas(const renderer&                   renderer,
+                                     const std::vector<texture>&       pages,
+                                     const std::vector<baked_glyph>&   glyphs,
+                                     const std::vector<baked_kerning>& kernings,
+                                     int                               line_height)
+{
+    return sdl_glyph_atlas::create_baked(renderer, pages, glyphs, kernings, line_height);
+}
+
+/** @brief Create a glyph atlas */
+glyph_atlas sdl_glyph_atlas::create(const renderer& renderer, const font& font, int page_size)
+{
+    glyph_atlas instance;
+    if (renderer && font)
+    {
+        texture_atlas atlas = create_texture_atlas(renderer, page_size, page_size);
+        if (atlas)
+        {
+            auto p = new sdl_glyph_atlas(renderer, font, atlas, 0, font->get_height(), font->get_line_skip());
+            instance.reset(p);
+        }
+    }
+    return instance;
+}
+
+/** @brief Create a glyph atlas storing the signed distance fields of the glyphs */
+glyph_atlas sdl_glyph_atlas::create_sdf(const renderer& renderer, const font& font, int spread, int page_size)
+{
+    glyph_atlas instance;
+    if (renderer && font && (spread > 0))
+    {
+        texture_atlas atlas = create_texture_atlas(renderer, page_size, page_size);
+        if (atlas)
+        {
+            auto p = new sdl_glyph_atlas(renderer, font, atlas, spread, font->get_height(), font->get_line_skip());
+            instance.reset(p);
+        }
+    }
+    return instance;
+}
+
+/** @brief Create a glyph atlas from a pre-rasterized font */
+glyph_atlas sdl_glyph_atlas::create_baked(const renderer&                   renderer,
+                                          const std::vector<texture>&       pages,
+                                          const std::vector<baked_glyph>&   glyphs,
+                                          const std::vector<baked_kerning>& kernings,
+                                          int                               line_height)
+{
+    glyph_atlas instance;
+    bool        is_valid = (renderer && !pages.empty());
+    for (const auto& page : pages)
+    {
+        is_valid = is_valid && page;
+    }
+    if (is_valid)
+    {
+        auto p = new sdl_glyph_atlas(renderer, nullptr, nullptr, 0, line_height, line_height);
+        instance.reset(p);
+
+        // All the glyphs are known in advance
+        for (const auto& baked : glyphs)
+        {
+            glyph g = {{nullptr, baked.rect}, {0.f, 0.f, 0.f, 0.f}, baked.offset_x, baked.offset_y, baked.advance};
+            if ((baked.page < pages.size()) && (baked.rect.w > 0) && (baked.rect.h > 0))
+            {
+                SDL_Rect page_size = pages[baked.page]->get_size();
+                g.region.source    = pages[baked.page];
+                g.tex_coords.x     = static_cast<float>(baked.rect.x) / static_cast<float>(page_size.w);
+                g.tex_coords.y     = static_cast<float>(baked.rect.y) / static_cast<float>(page_size.h);
+                g.tex_coords.w     = static_cast<float>(baked.rect.w) / static_cast<float>(page_size.w);
+                g.tex_coords.h     = static_cast<float>(baked.rect.h) / static_cast<float>(page_size.h);
+            }
+            else
+            {
+                // Empty glyph (ex: space)
+                g.region.rect = {0, 0, 0, 0};
+            }
+            p->m_glyphs[baked.ch] = g;
+        }
+        for (const auto& kerning : kernings)
+        {
+            p->m_kernings[(static_cast<Uint64>(kerning.first) << 32u) | kerning.second] = kerning.amount;
+        }
+    }
+    return instance;
+}
+
+/** @brief Constructor */
+sdl_glyph_atlas::sdl_glyph_atlas(
+    const renderer& renderer, const font& font, const texture_atlas& atlas, int spread, int height, int line_skip)
+    : m_renderer(renderer),
+      m_font(font),
+      m_atlas(atlas),
+      m_glyphs(),
+      m_kernings(),
+      m_height(height),
+      m_line_skip(line_skip),
+      m_spread(spread),
+      m_sdf_pages(),
+      m_sharpened_pixels(),
+      m_vertices(),
+      m_indices()
+{
+}
+
+/** @brief Compute the size of a text */
+SDL_Rect sdl_glyph_atlas::measure(const std::string& text, float scale)
+{
+    SDL_Rect size = layout(text, layout_handler());
+    if (is_sdf())
+    {
+        size.w = static_cast<int>(std::ceil(static_cast<float>(size.w) * scale));
+        size.h = static_cast<int>(std::ceil(static_cast<float>(size.h) * scale));
+    }
+    return size;
+}
+
+/** @brief Draw a text on the current target of the renderer */
+bool sdl_glyph_atlas::draw(const std::string& text, int x, int y, const SDL_Color& color, float scale)
+{
+    bool      ret          = true;
+    Uint8     alpha        = ((color.a == 0) ? static_cast<Uint8>(SDL_ALPHA_OPAQUE) : color.a);
+    SDL_Color vertex_color = {color.r, color.g, color.b, alpha};
+    texture   page;
+
+    // Bitmap glyphs are always drawn at their size, distance fields are drawn from the page sharpened for the nearest scale step
+    int scale_step = 0;
+    if (is_sdf())
+    {
+        scale_step = static_cast<int>(std::lround(std::log2(std::max(scale, 0.001f)) * static_cast<float>(SCALE_STEPS)));
+        scale_step = std::min(std::max(scale_step, MIN_SCALE_STEP), MAX_SCALE_STEP);
+    }
+    else
+    {
+        scale = 1.f;
+    }
+
+    m_vertices.clear();
+    m_indices.clear();
+    layout(text,
+           [&](const glyph& g, int glyph_x, int glyph_y)
+           {
+               if (g.region.source)
+               {
+                   // Draw the pending quads when the page changes
+                   texture glyph_page = (is_sdf() ? get_sdf_page(g.region.source, scale_step) : g.region.source);
+                   if (glyph_page != page)
+                   {
+                       ret  = flush(page) && ret;
+                       page = glyph_page;
+                   }
+
+                   // Add a quad for the glyph, distance fields are surrounded by their spread
+                   float left   = static_cast<float>(x) + static_cast<float>(glyph_x - m_spread) * scale;
+                   float top    = static_cast<float>(y) + static_cast<float>(glyph_y - m_spread) * scale;
+                   float right  = left + static_cast<float>(g.region.rect.w) * scale;
+                   float bottom = top + static_cast<float>(g.region.rect.h) * scale;
+                   float u0     = g.tex_coords.x;
+                   float v0     = g.tex_coords.y;
+                   float u1     = g.tex_coords.x + g.tex_coords.w;
+                   float v1     = g.tex_coords.y + g.tex_coords.h;
+                   int   first  = static_cast<int>(m_vertices.size());
+                   m_vertices.push_back({{left, top}, vertex_color, {u0, v0}});
+                   m_vertices.push_back({{right, top}, vertex_color, {u1, v0}});
+                   m_vertices.push_back({{right, bottom}, vertex_color, {u1, v1}});
+                   m_vertices.push_back({{left, bottom}, vertex_color, {u0, v1}});
+                   m_indices.insert(m_indices.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+               }
+           });
+    ret = flush(page) && ret;
+
+    return ret;
+}
+
+/** @brief Rasterize in advance the glyphs of a text */
+void sdl_glyph_atlas::preload(const std::string& text)
+{
+    size_t pos = 0;
+    while (pos < text.size())
+    {
+        get_glyph(sdl_font::next_code_point(text, pos));
+    }
+}
+
+/** @brief Get a glyph, rasterize it if needed */
+const sdl_glyph_atlas::glyph& sdl_glyph_atlas::get_glyph(Uint32 ch)
+{
+    auto iter_glyph = m_glyphs.find(ch);
+    if (iter_glyph == m_glyphs.end())
+    {
+        glyph g       = {{nullptr, {0, 0, 0, 0}}, {0.f, 0.f, 0.f, 0.f}, 0, 0, 0};
+        int   minx    = 0;
+        int   maxx    = 0;
+        int   miny    = 0;
+        int   maxy    = 0;
+        int   advance = 0;
+        if (m_font && m_font->get_glyph_metrics(ch, minx, maxx, miny, maxy, advance))
+        {
+            // The glyph is rendered in white, the text color is applied with the vertex colors
+            // The rendered surface starts at the left of the glyph if it overlaps the previous one
+            g.offset_x = std::min(minx, 0);
+            g.advance  = advance;
+
+            bool is_added = false;
+            if (is_sdf())
+            {
+                is_added = add_sdf_glyph(ch, g.region);
+            }
+            else
+            {
+                surface image = m_font->render_glyph_blended(ch, SDL_Color{255, 255, 255, 255});
+                is_added      = (image && m_atlas->add(image, g.region));
+            }
+            if (is_added)
+            {
+                SDL_Rect page_size = g.region.source->get_size();
+                g.tex_coords.x     = static_cast<float>(g.region.rect.x) / static_cast<float>(page_size.w);
+                g.tex_coords.y     = static_cast<float>(g.region.rect.y) / static_cast<float>(page_size.h);
+                g.tex_coords.w     = static_cast<float>(g.region.rect.w) / static_cast<float>(page_size.w);
+                g.tex_coords.h     = static_cast<float>(g.region.rect.h) / static_cast<float>(page_size.h);
+            }
+            else
+            {
+                // Empty glyph (ex: space)
+                g.region.source = nullptr;
+            }
+        }
+        iter_glyph = m_glyphs.emplace(ch, g).first;
+    }
+    return iter_glyph->second;
+}
+
+/** @brief Get the kerning between 2 glyphs */
+int sdl_glyph_atlas::get_kerning(Uint32 previous_ch, Uint32 ch)
+{
+    Uint64 key          = ((static_cast<Uint64>(previous_ch) << 32u) | ch);
+    auto   iter_kerning = m_kernings.find(key);
+    if (iter_kerning == m_kernings.end())
+    {
+        iter_kerning = m_kernings.emplace(key, (m_font ? m_font->get_kerning(previous_ch, ch) : 0)).first;
+    }
+    return iter_kerning->second;
+}
+
+/** @brief Compute the position of each glyph of a text and return the size of the text */
+SDL_Rect sdl_glyph_atlas::layout(const std::string& text, const layout_handler& handler)
+{
+    SDL_Rect size        = {0, 0, 0, 0};
+    int      pen_x       = 0;
+    int      pen_y       = 0;
+    Uint32   previous_ch = 0;
+    size_t   pos         = 0;
+    if (!text.empty())
+    {
+        size.h = m_height;
+    }
+    while (pos < text.size())
+    {
+        Uint32 ch = sdl_font::next_code_point(text, pos);
+        if (ch == '\n')
+        {
+            // Next line
+            pen_x       = 0;
+            pen_y       = pen_y + m_line_skip;
+            size.h      = pen_y + m_height;
+            previous_ch = 0;
+        }
+        else
+        {
+            const glyph& g = get_glyph(ch);
+            if (previous_ch != 0)
+            {
+                pen_x += get_kerning(previous_ch, ch);
+            }
+            if (handler)
+            {
+                handler(g, pen_x + g.offset_x, pen_y + g.offset_y);
+            }
+            size.w      = std::max(size.w, std::max(pen_x + g.offset_x + g.region.rect.w - 2 * m_spread, pen_x + g.advance));
+            pen_x       = pen_x + g.advance;
+            previous_ch = ch;
+        }
+    }
+    return size;
+}
+
+/** @brief Draw the pending quads */
+bool sdl_glyph_atlas::flush(texture& page)
+{
+    bool ret = true;
+    if (page && !m_indices.empty())
+    {
+        ret = m_renderer->draw_geometry(
+            page, &m_vertices[0], static_cast<int>(m_vertices.size()), &m_indices[0], static_cast<int>(m_indices.size()));
+    }
+    m_vertices.clear();
+    m_indices.clear();
+    return ret;
+}
+
+/** @brief Add the signed distance field of a glyph to the atlas */
+bool sdl_glyph_atlas::add_sdf_glyph(Uint32 ch, texture_region& region)
+{
+    bool               ret = false;
+    std::vector<Uint8> distances;
+    int                w = 0;
+    int                h = 0;
+    if (m_font->render_glyph_sdf(ch, m_spread, distances, w, h))
+    {
+        // The atlas holds the glyphs sharpened for a scale of 1
+        m_sharpened_pixels.resize(distances.size());
+        sharpen(&distances[0], distances.size(), 0, &m_sharpened_pixels[0]);
+        if (m_atlas->add(&m_sharpened_pixels[0], w * static_cast<int>(sizeof(Uint32)), w, h, region))
+        {
+            // Keep the distances to sharpen the page for other scales
+            auto iter_page = std::find_if(
+                m_sdf_pages.begin(), m_sdf_pages.end(), [&region](const sdf_page& p) { return (p.source == region.source); });
+            if (iter_page == m_sdf_pages.end())
+            {
+                SDL_Rect page_size = region.source->get_size();
+                region.source->set_scale_mode(SDL_ScaleModeLinear);
+                m_sdf_pages.push_back(
+                    {region.source, std::vector<Uint8>(static_cast<size_t>(page_size.w) * static_cast<size_t>(page_size.h), 0u), {}, {}});
+                iter_page = m_sdf_pages.end() - 1;
+            }
+            int page_width = iter_page->source->get_size().w;
+            for (int y = 0; y < h; y++)
+            {
+                std::copy(&distances[static_cast<size_t>(y) * static_cast<size_t>(w)],
+                          &distances[static_cast<size_t>(y) * static_cast<size_t>(w)] + w,
+                          &iter_page->distances[static_cast<size_t>(region.rect.y + y) * static_cast<size_t>(page_width) +
+                                                static_cast<size_t>(region.rect.x)]);
+            }
+            iter_page->glyphs.push_back(region.rect);
+            ret = true;
+        }
+    }
+    return ret;
+}
+
+/** @brief Get the page of the atlas to use to draw glyphs at a scale step */
+texture sdl_glyph_atlas::get_sdf_page(const texture& source, int scale_step)
+{
+    texture page = source;
+    if (scale_step != 0)
+    {
+        auto iter_page =
+            std::find_if(m_sdf_pages.begin(), m_sdf_pages.end(), [&source](const sdf_page& p) { return (p.source == source); });
+        if (iter_page != m_sdf_pages.end())
+        {
+            // Sharpen the whole page for the scale step when it is first used
+            sharpened_page& sharpened = iter_page->sharpened[scale_step];
+            SDL_Rect        page_size = source->get_size();
+            if (!sharpened.contents)
+            {
+                sharpened.contents = m_renderer->create_texture(m_atlas->get_format(), SDL_TEXTUREACCESS_STATIC, page_size.w, page_size.h);
+                if (sharpened.contents)
+                {
+                    sharpened.contents->set_blend_mode(SDL_BLENDMODE_BLEND);
+                    sharpened.contents->set_scale_mode(SDL_ScaleModeLinear);
+
+                    m_sharpened_pixels.resize(iter_page->distances.size());
+                    sharpen(&iter_page->distances[0], iter_page->distances.size(), scale_step, &m_sharpened_pixels[0]);
+                    if (sharpened.contents->update(nullptr, &m_sharpened_pixels[0], page_size.w * static_cast<int>(sizeof(Uint32))))
+                    {
+                        sharpened.glyph_count = iter_page->glyphs.size();
+                    }
+                    else
+                    {
+                        sharpened.contents = nullptr;
+                    }
+                }
+            }
+
+            // Then only upload the glyphs added to the page since
+            while (sharpened.contents && (sharpened.glyph_count < iter_page->glyphs.size()))
+            {
+                const SDL_Rect& rect = iter_page->glyphs[sharpened.glyph_count];
+                m_sharpened_pixels.resize(static_cast<size_t>(rect.w) * static_cast<size_t>(rect.h));
+                for (int y = 0; y < rect.h; y++)
+                {
+                    sharpen(&iter_page->distances[static_cast<size_t>(rect.y + y) * static_cast<size_t>(page_size.w) +
+                                                  static_cast<size_t>(rect.x)],
+                            static_cast<size_t>(rect.w),
+                            scale_step,
+                            &m_sharpened_pixels[static_cast<size_t>(y) * static_cast<size_t>(rect.w)]);
+                }
+                sharpened.contents->update(&rect, &m_sharpened_pixels[0], rect.w * static_cast<int>(sizeof(Uint32)));
+                sharpened.glyph_count++;
+            }
+            if (sharpened.contents)
+            {
+                page = sharpened.contents;
+            }
+        }
+    }
+    return page;
+}
+
+/** @brief Convert distances to pixels of the atlas format with the edges sharpened for a scale */
+void sdl_glyph_atlas::sharpen(const Uint8* distances, size_t count, int scale_step, Uint32* pixels) const
+{
+    // White pixels, the text color is applied with the vertex colors
+    int    bpp    = 0;
+    Uint32 r_mask = 0u;
+    Uint32 g_mask = 0u;
+    Uint32 b_mask = 0u;
+    Uint32 a_mask = 0u;
+    SDL_PixelFormatEnumToMasks(m_atlas->get_format(), &bpp, &r_mask, &g_mask, &b_mask, &a_mask);
+
+    // The coverage goes from 0 to 1 over a single pixel of the screen around the outline
+    Uint32 lut[256u];
+    float  scale    = std::exp2(static_cast<float>(scale_step) / static_cast<float>(SCALE_STEPS));
+    float  to_texel = static_cast<float>(m_spread) / 127.f;
+    for (Uint32 i = 0; i < 256u; i++)
+    {
+        float distance = (static_cast<float>(i) - 128.f) * to_texel;
+        float coverage = std::min(std::max(0.5f + distance * scale, 0.f), 1.f);
+        lut[i]         = (r_mask | g_mask | b_mask) | (static_cast<Uint32>(coverage * 255.f + 0.5f) * (a_mask / 0xFFu));
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        pixels[i] = lut[distances[i]];
+    }
+}
+
+} // namespace sdl
@@ -0,0 +1,287 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SDL_GLYPH_ATLAS_H
+#define SDL_GLYPH_ATLAS_H
+
+#include <SDL2/SDL.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sdl_font.h"
+#include "sdl_texture_atlas.h"
+
+namespace sdl
+{
+
+// Forward declarations
+class sdl_glyph_atlas;
+
+/** @brief SDL glyph atlas */
+using glyph_atlas = std::shared_ptr<sdl_glyph_atlas>;
+
+/** @brief Glyph of a pre-rasterized font */
+struct baked_glyph
+{
+    /** @brief Unicode code point */
+    Uint32 ch;
+    /** @brief Index of the page containing the glyph */
+    Uint32 page;
+    /** @brief Position and size of the glyph in its page */
+    SDL_Rect rect;
+    /** @brief Horizontal offset of the glyph from the pen position */
+    int offset_x;
+    /** @brief Vertical offset of the glyph from the top of the line */
+    int offset_y;
+    /** @brief Horizontal advance of the pen */
+    int advance;
+};
+
+/** @brief Kerning between 2 glyphs of a pre-rasterized font */
+struct baked_kerning
+{
+    /** @brief Unicode code point of the first glyph */
+    Uint32 first;
+    /** @brief Unicode code point of the second glyph */
+    Uint32 second;
+    /** @brief Horizontal adjustment of the pen between the glyphs */
+    int amount;
+};
+
+/**
+ * @brief Create a glyph atlas
+ * @param renderer Renderer which will draw the texts
+ * @param font Font of the glyphs
+ * @param page_size Size in pixels of the pages of the texture atlas storing the glyphs
+ * @return SDL glyph atlas object if the creation was successfull, nullptr otherwise
+ */
+glyph_atlas create_glyph_atlas(const renderer& renderer, const font& font, int page_size = 512);
+
+/**
+ * @brief Create a glyph atlas storing the signed distance fields of the glyphs, the texts can be drawn at any scale
+ *        The renderer has no shader to threshold the fields when drawing, the pages are thresholded on the CPU and cached
+ *        for each scale step used (half power of 2), the scales between 2 steps are drawn by stretching the nearest step
+ * @param renderer Renderer which will draw the texts
+ * @param font Font of the glyphs, the fields are computed at its point size
+ * @param spread Distance in pixels covered by the fields on each side of the outlines, limits the minimal scale
+ * @param page_size Size in pixels of the pages of the texture atlas storing the glyphs
+ * @return SDL glyph atlas object if the creation was successfull, nullptr otherwise
+ */
+glyph_atlas create_sdf_glyph_atlas(const renderer& renderer, const font& font, int spread = 4, int page_size = 512);
+
+/**
+ * @brief Create a glyph atlas from a pre-rasterized font, no glyph is rasterized at runtime
+ * @param renderer Renderer which will draw the texts
+ * @param pages Textures containing the glyphs
+ * @param glyphs Glyphs of the font, the glyphs which are not listed are considered empty
+ * @param kernings Kernings between the glyphs of the font
+ * @param line_height Height of a line of text
+ * @return SDL glyph atlas object if the creation was successfull, nullptr otherwise
+ */
+glyph_atlas create_baked_glyph_atlas(const renderer&                   renderer,
+                                     const std::vector<texture>&       pages,
+                                     const std::vector<baked_glyph>&   glyphs,
+                                     const std::vector<baked_kerning>& kernings,
+                                     int                               line_height);
+
+/** @brief Text renderer which rasterizes each glyph of a font only once into a texture atlas
+ *         and draws the texts as textured quads with a single geometry call per atlas page */
+class sdl_glyph_atlas
+{
+  public:
+    /**
+     * @brief Create a glyph atlas
+     * @param renderer Renderer which will draw the texts
+     * @param font Font of the glyphs
+     * @param page_size Size in pixels of the pages of the texture atlas storing the glyphs
+     * @return SDL glyph atlas object if the creation was successfull, nullptr otherwise
+     */
+    static glyph_atlas create(const renderer& renderer, const font& font, int page_size);
+
+    /**
+     * @brief Create a glyph atlas storing the signed distance fields of the glyphs, the texts can be drawn at any scale
+     *        The renderer has no shader to threshold the fields when drawing, the pages are thresholded on the CPU and cached
+     *        for each scale step used (half power of 2), the scales between 2 steps are drawn by stretching the nearest step
+     * @param renderer Renderer which will draw the texts
+     * @param font Font of the glyphs, the fields are computed at its point size
+     * @param spread Distance in pixels covered by the fields on each side of the outlines, limits the minimal scale
+     * @param page_size Size in pixels of the pages of the texture atlas storing the glyphs
+     * @return SDL glyph atlas object if the creation was successfull, nullptr otherwise
+     */
+    static glyph_atlas create_sdf(const renderer& renderer, const font& font, int spread, int page_size);
+
+    /**
+     * @brief Create a glyph atlas from a pre-rasterized font, no glyph is rasterized at runtime
+     * @param renderer Renderer which will draw the texts
+     * @param pages Textures containing the glyphs
+     * @param glyphs Glyphs of the font, the glyphs which are not listed are considered empty
+     * @param kernings Kernings between the glyphs of the font
+     * @param line_height Height of a line of text
+     * @return SDL glyph atlas object if the creation was successfull, nullptr otherwise
+     */
+    static glyph_atlas create_baked(const renderer&                   renderer,
+                                    const std::vector<texture>&       pages,
+                                    const std::vector<baked_glyph>&   glyphs,
+                                    const std::vector<baked_kerning>& kernings,
+                                    int                               line_height);
+
+    /** @brief Destructor */
+    ~sdl_glyph_atlas() = default;
+
+    /** @brief Copy constructor => deleted */
+    sdl_glyph_atlas(const sdl_glyph_atlas& copy) = delete;
+    /** @brief Copy assignment => deleted */
+    sdl_glyph_atlas& operator=(const sdl_glyph_atlas& copy) = delete;
+
+    /**
+     * @brief Compute the size of a text
+     * @param text UTF-8 text, lines are separated by '\n'
+     * @param scale Scaling applied to the font size (signed distance field atlas only)
+     * @return Size of the text (x and y are always 0)
+     */
+    SDL_Rect measure(const std::string& text, float scale = 1.f);
+
+    /**
+     * @brief Draw a text on the current target of the renderer
+     * @param text UTF-8 text, lines are separated by '\n'
+     * @param x Left position of the text
+     * @param y Top position of the text
+     * @param color Text color (a null alpha is considered opaque as with the text rendering of the font)
+     * @param scale Scaling applied to the font size (signed distance field atlas only)
+     * @return true if the text has been drawn, false otherwise
+     */
+    bool draw(const std::string& text, int x, int y, const SDL_Color& color, float scale = 1.f);
+
+    /** @brief Rasterize in advance the glyphs of a text (ex: all the digits of a counter) */
+    void preload(const std::string& text);
+
+    /** @brief Get the renderer which draws the texts */
+    const renderer& get_renderer() const { return m_renderer; }
+    /** @brief Get the font of the glyphs (nullptr for a pre-rasterized font) */
+    const font& get_font() const { return m_font; }
+    /** @brief Get the number of rasterized glyphs */
+    size_t get_glyph_count() const { return m_glyphs.size(); }
+    /** @brief Indicate if the atlas stores signed distance fields */
+    bool is_sdf() const { return (m_spread != 0); }
+
+  private:
+    /** @brief Rasterized glyph */
+    struct glyph
+    {
+        /** @brief Area of the atlas containing the glyph (no texture if the glyph is empty) */
+        texture_region region;
+        /** @brief Normalized texture coordinates of the glyph */
+        SDL_FRect tex_coords;
+        /** @brief Horizontal offset of the glyph from the pen position */
+        int offset_x;
+        /** @brief Vertical offset of the glyph from the top of the line */
+        int offset_y;
+        /** @brief Horizontal advance of the pen */
+        int advance;
+    };
+
+    /** @brief Handler called for each glyph of a text with its position */
+    using layout_handler = std::function<void(const glyph& g, int x, int y)>;
+
+    /** @brief Copy of a page of the atlas with edges sharpened for a scale */
+    struct sharpened_page
+    {
+        /** @brief Texture holding the sharpened glyphs */
+        texture contents;
+        /** @brief Number of glyphs of the page already sharpened in the texture */
+        size_t glyph_count;
+    };
+
+    /** @brief Distances of the glyphs of a page of a signed distance field atlas */
+    struct sdf_page
+    {
+        /** @brief Page of the atlas, sharpened for a scale of 1 */
+        texture source;
+        /** @brief Distance of each pixel of the page to the outline of its glyph */
+        std::vector<Uint8> distances;
+        /** @brief Areas of the glyphs of the page, in the order in which they have been added */
+        std::vector<SDL_Rect> glyphs;
+        /** @brief Copies of the page sharpened for other scales, indexed by scale step */
+        std::map<int, sharpened_page> sharpened;
+    };
+
+    /** @brief Number of scale steps per power of 2 */
+    static constexpr int SCALE_STEPS = 2;
+    /** @brief Minimal scale step */
+    static constexpr int MIN_SCALE_STEP = -2 * SCALE_STEPS;
+    /** @brief Maximal scale step */
+    static constexpr int MAX_SCALE_STEP = 4 * SCALE_STEPS;
+
+    /** @brief Renderer which draws the texts */
+    renderer m_renderer;
+    /** @brief Font of the glyphs (nullptr for a pre-rasterized font) */
+    font m_font;
+    /** @brief Texture atlas storing the glyphs (nullptr for a pre-rasterized font) */
+    texture_atlas m_atlas;
+    /** @brief Rasterized glyphs indexed by code point */
+    std::unordered_map<Uint32, glyph> m_glyphs;
+    /** @brief Kerning between 2 glyphs indexed by their code points */
+    std::unordered_map<Uint64, int> m_kernings;
+    /** @brief Height of a line of text */
+    int m_height;
+    /** @brief Spacing between 2 lines of text */
+    int m_line_skip;
+    /** @brief Distance covered by the signed distance fields on each side of the outlines (0 if the glyphs are bitmaps) */
+    int m_spread;
+    /** @brief Distances of the pages of a signed distance field atlas */
+    std::vector<sdf_page> m_sdf_pages;
+    /** @brief Pixels used to upload the sharpened glyphs */
+    std::vector<Uint32> m_sharpened_pixels;
+    /** @brief Vertices of the quads being drawn */
+    std::vector<SDL_Vertex> m_vertices;
+    /** @brief Indices of the quads being drawn */
+    std::vector<int> m_indices;
+
+    /** @brief Constructor */
+    sdl_glyph_atlas(const renderer& renderer, const font& font, const texture_atlas& atlas, int spread, int height, int line_skip);
+
+    /** @brief Get a glyph, rasterize it if needed */
+    const glyph& get_glyph(Uint32 ch);
+    /** @brief Get the kerning between 2 glyphs */
+    int get_kerning(Uint32 previous_ch, Uint32 ch);
+    /** @brief Compute the position of each glyph of a text and return the size of the text */
+    SDL_Rect layout(const std::string& text, const layout_handler& handler);
+    /** @brief Draw the pending quads */
+    bool flush(texture& page);
+
+    /** @brief Add the signed distance field of a glyph to the atlas */
+    bool add_sdf_glyph(Uint32 ch, texture_region& region);
+    /** @brief Get the page of the atlas to use to draw glyphs at a scale step */
+    texture get_sdf_page(const texture& source, int scale_step);
+    /**
+     * @brief Convert distances to pixels of the atlas format with the edges sharpened for a scale
+     * @param distances Distances of the glyphs
+     * @param count Number of pixels
+     * @param scale_step Scale step for which the edges must be sharp
+     * @param pixels Converted pixels
+     */
+    void sharpen(const Uint8* distances, size_t count, int scale_step, Uint32* pixels) const;
+};
+
+} // namespace sdl
+
+#endif // SDL_GLYPH_ATLAS_H
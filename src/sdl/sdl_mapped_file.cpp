@@ -0,0 +1,131 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sdl_mapped_file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else // _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+namespace sdl
+{
+
+/** @brief Map a file in memory for reading */
+mapped_file map_file(const std::string& path)
+{
+    return sdl_mapped_file::map(path);
+}
+
+#ifdef _WIN32
+
+/** @brief Map a file in memory for reading */
+mapped_file sdl_mapped_file::map(const std::string& path)
+{
+    mapped_file instance;
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER size;
+        HANDLE        mapping = nullptr;
+        if (GetFileSizeEx(file, &size) && (size.QuadPart > 0))
+        {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        }
+        if (mapping)
+        {
+            const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (data)
+            {
+                auto p       = new sdl_mapped_file(static_cast<const Uint8*>(data), static_cast<size_t>(size.QuadPart));
+                p->m_file    = file;
+                p->m_mapping = mapping;
+                instance.reset(p);
+            }
+            else
+            {
+                CloseHandle(mapping);
+            }
+        }
+        if (!instance)
+        {
+            CloseHandle(file);
+        }
+    }
+
+    return instance;
+}
+
+/** @brief Destructor */
+sdl_mapped_file::~sdl_mapped_file()
+{
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+    CloseHandle(m_file);
+}
+
+/** @brief Constructor */
+sdl_mapped_file::sdl_mapped_file(const Uint8* data, size_t size) : m_data(data), m_size(size), m_file(nullptr), m_mapping(nullptr) { }
+
+#else // _WIN32
+
+/** @brief Map a file in memory for reading */
+mapped_file sdl_mapped_file::map(const std::string& path)
+{
+    mapped_file instance;
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        struct stat file_stat;
+        if ((fstat(fd, &file_stat) == 0) && (file_stat.st_size > 0))
+        {
+            size_t size = static_cast<size_t>(file_stat.st_size);
+            void*  data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                auto p = new sdl_mapped_file(static_cast<const Uint8*>(data), size);
+                instance.reset(p);
+            }
+        }
+
+        // The mapping stays valid after the file has been closed
+        close(fd);
+    }
+
+    return instance;
+}
+
+/** @brief Destructor */
+sdl_mapped_file::~sdl_mapped_file()
+{
+    munmap(const_cast<Uint8*>(m_data), m_size);
+}
+
+/** @brief Constructor */
+sdl_mapped_file::sdl_mapped_file(const Uint8* data, size_t size) : m_data(data), m_size(size) { }
+
+#endif // _WIN32
+
+} // namespace sdl
@@ -0,0 +1,88 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SDL_MAPPED_FILE_H
+#define SDL_MAPPED_FILE_H
+
+#include <SDL2/SDL.h>
+#include <memory>
+#include <string>
+
+namespace sdl
+{
+
+// Forward declarations
+class sdl_mapped_file;
+
+/** @brief Read-only memory mapped file */
+using mapped_file = std::shared_ptr<sdl_mapped_file>;
+
+/**
+ * @brief Map a file in memory for reading
+ * @param path Path to the file
+ * @return Mapped file object if the mapping was successfull, nullptr otherwise
+ */
+mapped_file map_file(const std::string& path);
+
+/** @brief Wrapper for a read-only memory mapping of a file */
+class sdl_mapped_file
+{
+  public:
+    /**
+     * @brief Map a file in memory for reading
+     * @param path Path to the file
+     * @return Mapped file object if the mapping was successfull, nullptr otherwise
+     */
+    static mapped_file map(const std::string& path);
+
+    /** @brief Destructor */
+    ~sdl_mapped_file();
+
+    /** @brief Copy constructor => deleted */
+    sdl_mapped_file(const sdl_mapped_file& copy) = delete;
+    /** @brief Copy assignment => deleted */
+    sdl_mapped_file& operator=(const sdl_mapped_file& copy) = delete;
+
+    /** @brief Get the contents of the file */
+    const Uint8* get_data() const { return m_data; }
+    /** @brief Get the size of the file in bytes */
+    size_t get_size() const { return m_size; }
+
+  private:
+    /** @brief Mapped contents */
+    const Uint8* m_data;
+    /** @brief Size of the mapping */
+    size_t m_size;
+#ifdef _WIN32
+    /** @brief File handle */
+    void* m_file;
+    /** @brief Mapping handle */
+    void* m_mapping;
+#endif // _WIN32
+
+    /** 
+     * @brief Constructor 
+     * @param data Mapped contents
+     * @param size Size of the mapping
+     */
+    sdl_mapped_file(const Uint8* data, size_t size);
+};
+
+} // namespace sdl
+
+#endif // SDL_MAPPED_FILE_H
@@ -0,0 +1,631 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sdl_pixel_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SDL_PIXEL_KERNELS_X86
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define SSE2_TARGET __attribute__((target("sse2")))
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define SSE2_TARGET
+#define AVX2_TARGET
+#endif
+#endif
+
+namespace sdl
+{
+
+/** @brief Exact rounded division by 255 of a product of two 8 bits values */
+static inline Uint32 div255(Uint32 x)
+{
+    x += 128u;
+    return ((x + (x >> 8u)) >> 8u);
+}
+
+/** @brief Multiply the color channels by the alpha channel (portable C++) */
+static void premultiply_scalar(Uint32* pixels, size_t count, int a_shift)
+{
+    const Uint32 a_mask = (0xFFu << a_shift);
+    for (size_t i = 0; i < count; i++)
+    {
+        Uint32 pixel = pixels[i];
+        Uint32 alpha = ((pixel >> a_shift) & 0xFFu);
+        Uint32 out   = (pixel & a_mask);
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            if (shift != a_shift)
+            {
+                out |= (div255(((pixel >> shift) & 0xFFu) * alpha) << shift);
+            }
+        }
+        pixels[i] = out;
+    }
+}
+
+/** @brief Divide the color channels by the alpha channel (portable C++) */
+static void unpremultiply_scalar(Uint32* pixels, size_t count, int a_shift)
+{
+    const Uint32 a_mask = (0xFFu << a_shift);
+    for (size_t i = 0; i < count; i++)
+    {
+        Uint32 pixel = pixels[i];
+        Uint32 alpha = ((pixel >> a_shift) & 0xFFu);
+        if (alpha == 0)
+        {
+            pixels[i] = 0;
+        }
+        else if (alpha != 0xFFu)
+        {
+            float  scale = 255.f / static_cast<float>(alpha);
+            Uint32 out   = (pixel & a_mask);
+            for (int shift = 0; shift < 32; shift += 8)
+            {
+                if (shift != a_shift)
+                {
+                    float value = std::min(static_cast<float>((pixel >> shift) & 0xFFu) * scale, 255.f);
+                    out |= (static_cast<Uint32>(std::lrint(value)) << shift);
+                }
+            }
+            pixels[i] = out;
+        }
+    }
+}
+
+/** @brief Multiply each channel by the matching channel of a modulation pixel (portable C++) */
+static void modulate_scalar(Uint32* pixels, size_t count, Uint32 modulation)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        Uint32 pixel = pixels[i];
+        Uint32 out   = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            out |= (div255(((pixel >> shift) & 0xFFu) * ((modulation >> shift) & 0xFFu)) << shift);
+        }
+        pixels[i] = out;
+    }
+}
+
+/** @brief Blend non premultiplied pixels over other pixels (portable C++) */
+static void blend_scalar(Uint32* dst, const Uint32* src, size_t count, int a_shift)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        Uint32 s     = src[i];
+        Uint32 d     = dst[i];
+        Uint32 alpha = ((s >> a_shift) & 0xFFu);
+        Uint32 out   = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            Uint32 s_value = ((shift == a_shift) ? 0xFFu : ((s >> shift) & 0xFFu));
+            Uint32 d_value = ((d >> shift) & 0xFFu);
+            out |= (div255(s_value * alpha + d_value * (0xFFu - alpha)) << shift);
+        }
+        dst[i] = out;
+    }
+}
+
+/** @brief Convert pixels to another channel layout (portable C++) */
+static void convert_scalar(Uint32* dst, const Uint32* src, size_t count, const pixel_layout& src_layout, const pixel_layout& dst_layout)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        Uint32 pixel = src[i];
+        dst[i]       = (((pixel >> src_layout.r_shift) & 0xFFu) << dst_layout.r_shift) |
+                 (((pixel >> src_layout.g_shift) & 0xFFu) << dst_layout.g_shift) |
+                 (((pixel >> src_layout.b_shift) & 0xFFu) << dst_layout.b_shift) |
+                 (((pixel >> src_layout.a_shift) & 0xFFu) << dst_layout.a_shift);
+    }
+}
+
+/** @brief Bilinear interpolation of a destination row with 8 bits fixed point weights (portable C++) */
+static void resize_row_scalar(
+    const Uint32* top, const Uint32* bottom, int fy, const int* x0, const int* x1, const int* fx, Uint32* dst, int dst_w)
+{
+    const Uint32 wy1 = static_cast<Uint32>(fy);
+    const Uint32 wy0 = 256u - wy1;
+    for (int x = 0; x < dst_w; x++)
+    {
+        Uint32 wx1 = static_cast<Uint32>(fx[x]);
+        Uint32 wx0 = 256u - wx1;
+        Uint32 out = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            Uint32 left  = (((top[x0[x]] >> shift) & 0xFFu) * wy0 + ((bottom[x0[x]] >> shift) & 0xFFu) * wy1) >> 8u;
+            Uint32 right = (((top[x1[x]] >> shift) & 0xFFu) * wy0 + ((bottom[x1[x]] >> shift) & 0xFFu) * wy1) >> 8u;
+            out |= (((left * wx0 + right * wx1) >> 8u) << shift);
+        }
+        dst[x] = out;
+    }
+}
+
+#ifdef SDL_PIXEL_KERNELS_X86
+
+/** @brief Exact rounded division by 255 of 16 bits lanes holding products of two 8 bits values (SSE2) */
+SSE2_TARGET static inline __m128i div255_sse2(__m128i x)
+{
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+/** @brief Broadcast the alpha lane of each pixel unpacked in 16 bits lanes (SSE2) */
+template <int A>
+SSE2_TARGET static inline __m128i broadcast_alpha_sse2(__m128i x)
+{
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(A, A, A, A)), _MM_SHUFFLE(A, A, A, A));
+}
+
+/** @brief Multiply the color channels by the alpha channel, 4 pixels at a time (SSE2) */
+template <int A>
+SSE2_TARGET static void premultiply_sse2(Uint32* pixels, size_t count)
+{
+    const __m128i zero   = _mm_setzero_si128();
+    const __m128i a_mask = _mm_set1_epi32(static_cast<int>(0xFFu << (A * 8)));
+    size_t        i      = 0;
+    for (; (i + 4u) <= count; i += 4u)
+    {
+        __m128i p  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+        __m128i lo = _mm_unpacklo_epi8(p, zero);
+        __m128i hi = _mm_unpackhi_epi8(p, zero);
+        lo         = div255_sse2(_mm_mullo_epi16(lo, broadcast_alpha_sse2<A>(lo)));
+        hi         = div255_sse2(_mm_mullo_epi16(hi, broadcast_alpha_sse2<A>(hi)));
+        __m128i r  = _mm_or_si128(_mm_andnot_si128(a_mask, _mm_packus_epi16(lo, hi)), _mm_and_si128(p, a_mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), r);
+    }
+    premultiply_scalar(pixels + i, count - i, A * 8);
+}
+
+/** @brief Blend non premultiplied pixels over other pixels, 4 pixels at a time (SSE2) */
+template <int A>
+SSE2_TARGET static void blend_sse2(Uint32* dst, const Uint32* src, size_t count)
+{
+    const __m128i zero     = _mm_setzero_si128();
+    const __m128i c255     = _mm_set1_epi16(255);
+    const __m128i alpha255 = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(0xFFu << (A * 8))), zero);
+    size_t        i        = 0;
+    for (; (i + 4u) <= count; i += 4u)
+    {
+        __m128i s    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i d    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i s_lo = _mm_unpacklo_epi8(s, zero);
+        __m128i s_hi = _mm_unpackhi_epi8(s, zero);
+        __m128i a_lo = broadcast_alpha_sse2<A>(s_lo);
+        __m128i a_hi = broadcast_alpha_sse2<A>(s_hi);
+        s_lo         = _mm_mullo_epi16(_mm_or_si128(s_lo, alpha255), a_lo);
+        s_hi         = _mm_mullo_epi16(_mm_or_si128(s_hi, alpha255), a_hi);
+        __m128i d_lo = _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(c255, a_lo));
+        __m128i d_hi = _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(c255, a_hi));
+        __m128i r    = _mm_packus_epi16(div255_sse2(_mm_add_epi16(s_lo, d_lo)), div255_sse2(_mm_add_epi16(s_hi, d_hi)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), r);
+    }
+    blend_scalar(dst + i, src + i, count - i, A * 8);
+}
+
+/** @brief Multiply the color channels by the alpha channel (SSE2) */
+SSE2_TARGET static void premultiply_sse2(Uint32* pixels, size_t count, int a_shift)
+{
+    switch (a_shift)
+    {
+        case 0:
+            premultiply_sse2<0>(pixels, count);
+            break;
+        case 8:
+            premultiply_sse2<1>(pixels, count);
+            break;
+        case 16:
+            premultiply_sse2<2>(pixels, count);
+            break;
+        default:
+            premultiply_sse2<3>(pixels, count);
+            break;
+    }
+}
+
+/** @brief Divide the color channels by the alpha channel, 1 pixel at a time since each pixel needs its own division (SSE2) */
+SSE2_TARGET static void unpremultiply_sse2(Uint32* pixels, size_t count, int a_shift)
+{
+    const __m128i zero   = _mm_setzero_si128();
+    const __m128  c255   = _mm_set1_ps(255.f);
+    const Uint32  a_mask = (0xFFu << a_shift);
+    for (size_t i = 0; i < count; i++)
+    {
+        Uint32 pixel = pixels[i];
+        Uint32 alpha = ((pixel >> a_shift) & 0xFFu);
+        if (alpha == 0)
+        {
+            pixels[i] = 0;
+        }
+        else if (alpha != 0xFFu)
+        {
+            __m128i p = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(pixel)), zero), zero);
+            __m128  f = _mm_mul_ps(_mm_cvtepi32_ps(p), _mm_set1_ps(255.f / static_cast<float>(alpha)));
+            p         = _mm_cvtps_epi32(_mm_min_ps(f, c255));
+            p         = _mm_packus_epi16(_mm_packs_epi32(p, zero), zero);
+            pixels[i] = ((static_cast<Uint32>(_mm_cvtsi128_si32(p)) & ~a_mask) | (pixel & a_mask));
+        }
+    }
+}
+
+/** @brief Multiply each channel by the matching channel of a modulation pixel, 4 pixels at a time (SSE2) */
+SSE2_TARGET static void modulate_sse2(Uint32* pixels, size_t count, Uint32 modulation)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i m    = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(modulation)), zero);
+    size_t        i    = 0;
+    for (; (i + 4u) <= count; i += 4u)
+    {
+        __m128i p  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+        __m128i lo = div255_sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(p, zero), m));
+        __m128i hi = div255_sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(p, zero), m));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), _mm_packus_epi16(lo, hi));
+    }
+    modulate_scalar(pixels + i, count - i, modulation);
+}
+
+/** @brief Blend non premultiplied pixels over other pixels (SSE2) */
+SSE2_TARGET static void blend_sse2(Uint32* dst, const Uint32* src, size_t count, int a_shift)
+{
+    switch (a_shift)
+    {
+        case 0:
+            blend_sse2<0>(dst, src, count);
+            break;
+        case 8:
+            blend_sse2<1>(dst, src, count);
+            break;
+        case 16:
+            blend_sse2<2>(dst, src, count);
+            break;
+        default:
+            blend_sse2<3>(dst, src, count);
+            break;
+    }
+}
+
+/** @brief Convert pixels to another channel layout, 4 pixels at a time (SSE2) */
+SSE2_TARGET static void convert_sse2(
+    Uint32* dst, const Uint32* src, size_t count, const pixel_layout& src_layout, const pixel_layout& dst_layout)
+{
+    const __m128i ff    = _mm_set1_epi32(0xFF);
+    const __m128i src_r = _mm_cvtsi32_si128(src_layout.r_shift);
+    const __m128i src_g = _mm_cvtsi32_si128(src_layout.g_shift);
+    const __m128i src_b = _mm_cvtsi32_si128(src_layout.b_shift);
+    const __m128i src_a = _mm_cvtsi32_si128(src_layout.a_shift);
+    const __m128i dst_r = _mm_cvtsi32_si128(dst_layout.r_shift);
+    const __m128i dst_g = _mm_cvtsi32_si128(dst_layout.g_shift);
+    const __m128i dst_b = _mm_cvtsi32_si128(dst_layout.b_shift);
+    const __m128i dst_a = _mm_cvtsi32_si128(dst_layout.a_shift);
+    size_t        i     = 0;
+    for (; (i + 4u) <= count; i += 4u)
+    {
+        __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i r = _mm_sll_epi32(_mm_and_si128(_mm_srl_epi32(p, src_r), ff), dst_r);
+        __m128i g = _mm_sll_epi32(_mm_and_si128(_mm_srl_epi32(p, src_g), ff), dst_g);
+        __m128i b = _mm_sll_epi32(_mm_and_si128(_mm_srl_epi32(p, src_b), ff), dst_b);
+        __m128i a = _mm_sll_epi32(_mm_and_si128(_mm_srl_epi32(p, src_a), ff), dst_a);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a)));
+    }
+    convert_scalar(dst + i, src + i, count - i, src_layout, dst_layout);
+}
+
+/** @brief Bilinear interpolation of a destination row, the 4 channels of a pixel at a time (SSE2) */
+SSE2_TARGET static void resize_row_sse2(
+    const Uint32* top, const Uint32* bottom, int fy, const int* x0, const int* x1, const int* fx, Uint32* dst, int dst_w)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i wy0  = _mm_set1_epi16(static_cast<short>(256 - fy));
+    const __m128i wy1  = _mm_set1_epi16(static_cast<short>(fy));
+    for (int x = 0; x < dst_w; x++)
+    {
+        // Left pixel in the 4 low lanes, right pixel in the 4 high lanes
+        __m128i t  = _mm_unpacklo_epi32(_mm_cvtsi32_si128(static_cast<int>(top[x0[x]])), _mm_cvtsi32_si128(static_cast<int>(top[x1[x]])));
+        __m128i b  = _mm_unpacklo_epi32(_mm_cvtsi32_si128(static_cast<int>(bottom[x0[x]])),
+                                        _mm_cvtsi32_si128(static_cast<int>(bottom[x1[x]])));
+        t          = _mm_unpacklo_epi8(t, zero);
+        b          = _mm_unpacklo_epi8(b, zero);
+        __m128i v  = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(t, wy0), _mm_mullo_epi16(b, wy1)), 8);
+        short   w1 = static_cast<short>(fx[x]);
+        short   w0 = static_cast<short>(256 - fx[x]);
+        __m128i h  = _mm_mullo_epi16(v, _mm_set_epi16(w1, w1, w1, w1, w0, w0, w0, w0));
+        h          = _mm_srli_epi16(_mm_add_epi16(h, _mm_srli_si128(h, 8)), 8);
+        dst[x]     = static_cast<Uint32>(_mm_cvtsi128_si32(_mm_packus_epi16(h, zero)));
+    }
+}
+
+/** @brief Exact rounded division by 255 of 16 bits lanes holding products of two 8 bits values (AVX2) */
+AVX2_TARGET static inline __m256i div255_avx2(__m256i x)
+{
+    x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+/** @brief Broadcast the alpha lane of each pixel unpacked in 16 bits lanes (AVX2) */
+template <int A>
+AVX2_TARGET static inline __m256i broadcast_alpha_avx2(__m256i x)
+{
+    return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(x, _MM_SHUFFLE(A, A, A, A)), _MM_SHUFFLE(A, A, A, A));
+}
+
+/** @brief Multiply the color channels by the alpha channel, 8 pixels at a time (AVX2) */
+template <int A>
+AVX2_TARGET static void premultiply_avx2(Uint32* pixels, size_t count)
+{
+    const __m256i zero   = _mm256_setzero_si256();
+    const __m256i a_mask = _mm256_set1_epi32(static_cast<int>(0xFFu << (A * 8)));
+    size_t        i      = 0;
+    for (; (i + 8u) <= count; i += 8u)
+    {
+        __m256i p  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i));
+        __m256i lo = _mm256_unpacklo_epi8(p, zero);
+        __m256i hi = _mm256_unpackhi_epi8(p, zero);
+        lo         = div255_avx2(_mm256_mullo_epi16(lo, broadcast_alpha_avx2<A>(lo)));
+        hi         = div255_avx2(_mm256_mullo_epi16(hi, broadcast_alpha_avx2<A>(hi)));
+        __m256i r  = _mm256_or_si256(_mm256_andnot_si256(a_mask, _mm256_packus_epi16(lo, hi)), _mm256_and_si256(p, a_mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + i), r);
+    }
+    premultiply_sse2<A>(pixels + i, count - i);
+}
+
+/** @brief Blend non premultiplied pixels over other pixels, 8 pixels at a time (AVX2) */
+template <int A>
+AVX2_TARGET static void blend_avx2(Uint32* dst, const Uint32* src, size_t count)
+{
+    const __m256i zero     = _mm256_setzero_si256();
+    const __m256i c255     = _mm256_set1_epi16(255);
+    const __m256i alpha255 = _mm256_unpacklo_epi8(_mm256_set1_epi32(static_cast<int>(0xFFu << (A * 8))), zero);
+    size_t        i        = 0;
+    for (; (i + 8u) <= count; i += 8u)
+    {
+        __m256i s    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i d    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i s_lo = _mm256_unpacklo_epi8(s, zero);
+        __m256i s_hi = _mm256_unpackhi_epi8(s, zero);
+        __m256i a_lo = broadcast_alpha_avx2<A>(s_lo);
+        __m256i a_hi = broadcast_alpha_avx2<A>(s_hi);
+        s_lo         = _mm256_mullo_epi16(_mm256_or_si256(s_lo, alpha255), a_lo);
+        s_hi         = _mm256_mullo_epi16(_mm256_or_si256(s_hi, alpha255), a_hi);
+        __m256i d_lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), _mm256_sub_epi16(c255, a_lo));
+        __m256i d_hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), _mm256_sub_epi16(c255, a_hi));
+        __m256i r    = _mm256_packus_epi16(div255_avx2(_mm256_add_epi16(s_lo, d_lo)), div255_avx2(_mm256_add_epi16(s_hi, d_hi)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), r);
+    }
+    blend_sse2<A>(dst + i, src + i, count - i);
+}
+
+/** @brief Multiply the color channels by the alpha channel (AVX2) */
+AVX2_TARGET static void premultiply_avx2(Uint32* pixels, size_t count, int a_shift)
+{
+    switch (a_shift)
+    {
+        case 0:
+            premultiply_avx2<0>(pixels, count);
+            break;
+        case 8:
+            premultiply_avx2<1>(pixels, count);
+            break;
+        case 16:
+            premultiply_avx2<2>(pixels, count);
+            break;
+        default:
+            premultiply_avx2<3>(pixels, count);
+            break;
+    }
+}
+
+/** @brief Multiply each channel by the matching channel of a modulation pixel, 8 pixels at a time (AVX2) */
+AVX2_TARGET static void modulate_avx2(Uint32* pixels, size_t count, Uint32 modulation)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i m    = _mm256_unpacklo_epi8(_mm256_set1_epi32(static_cast<int>(modulation)), zero);
+    size_t        i    = 0;
+    for (; (i + 8u) <= count; i += 8u)
+    {
+        __m256i p  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i));
+        __m256i lo = div255_avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(p, zero), m));
+        __m256i hi = div255_avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(p, zero), m));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + i), _mm256_packus_epi16(lo, hi));
+    }
+    modulate_sse2(pixels + i, count - i, modulation);
+}
+
+/** @brief Blend non premultiplied pixels over other pixels (AVX2) */
+AVX2_TARGET static void blend_avx2(Uint32* dst, const Uint32* src, size_t count, int a_shift)
+{
+    switch (a_shift)
+    {
+        case 0:
+            blend_avx2<0>(dst, src, count);
+            break;
+        case 8:
+            blend_avx2<1>(dst, src, count);
+            break;
+        case 16:
+            blend_avx2<2>(dst, src, count);
+            break;
+        default:
+            blend_avx2<3>(dst, src, count);
+            break;
+    }
+}
+
+/** @brief Convert pixels to another channel layout, 8 pixels at a time (AVX2) */
+AVX2_TARGET static void convert_avx2(
+    Uint32* dst, const Uint32* src, size_t count, const pixel_layout& src_layout, const pixel_layout& dst_layout)
+{
+    const __m256i ff    = _mm256_set1_epi32(0xFF);
+    const __m128i src_r = _mm_cvtsi32_si128(src_layout.r_shift);
+    const __m128i src_g = _mm_cvtsi32_si128(src_layout.g_shift);
+    const __m128i src_b = _mm_cvtsi32_si128(src_layout.b_shift);
+    const __m128i src_a = _mm_cvtsi32_si128(src_layout.a_shift);
+    const __m128i dst_r = _mm_cvtsi32_si128(dst_layout.r_shift);
+    const __m128i dst_g = _mm_cvtsi32_si128(dst_layout.g_shift);
+    const __m128i dst_b = _mm_cvtsi32_si128(dst_layout.b_shift);
+    const __m128i dst_a = _mm_cvtsi32_si128(dst_layout.a_shift);
+    size_t        i     = 0;
+    for (; (i + 8u) <= count; i += 8u)
+    {
+        __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i r = _mm256_sll_epi32(_mm256_and_si256(_mm256_srl_epi32(p, src_r), ff), dst_r);
+        __m256i g = _mm256_sll_epi32(_mm256_and_si256(_mm256_srl_epi32(p, src_g), ff), dst_g);
+        __m256i b = _mm256_sll_epi32(_mm256_and_si256(_mm256_srl_epi32(p, src_b), ff), dst_b);
+        __m256i a = _mm256_sll_epi32(_mm256_and_si256(_mm256_srl_epi32(p, src_a), ff), dst_a);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_or_si256(_mm256_or_si256(r, g), _mm256_or_si256(b, a)));
+    }
+    convert_sse2(dst + i, src + i, count - i, src_layout, dst_layout);
+}
+
+#endif // SDL_PIXEL_KERNELS_X86
+
+/** @brief Constructor */
+sdl_pixel_kernels::sdl_pixel_kernels(instruction_set set,
+                                     alpha_kernel    premultiply,
+                                     alpha_kernel    unpremultiply,
+                                     modulate_kernel modulate,
+                                     blend_kernel    blend,
+                                     convert_kernel  convert,
+                                     resize_kernel   resize_row)
+    : m_set(set),
+      m_premultiply(premultiply),
+      m_unpremultiply(unpremultiply),
+      m_modulate(modulate),
+      m_blend(blend),
+      m_convert(convert),
+      m_resize_row(resize_row)
+{
+}
+
+/** @brief Get the kernels using the best instruction set supported by the CPU */
+const sdl_pixel_kernels& sdl_pixel_kernels::get()
+{
+    static const sdl_pixel_kernels& kernels =
+        get(SDL_HasAVX2() ? instruction_set::avx2 : (SDL_HasSSE2() ? instruction_set::sse2 : instruction_set::scalar));
+    return kernels;
+}
+
+/** @brief Get the kernels using an instruction set (scalar kernels if the instruction set is not available) */
+const sdl_pixel_kernels& sdl_pixel_kernels::get(instruction_set set)
+{
+    static const sdl_pixel_kernels scalar_kernels(instruction_set::scalar,
+                                                  premultiply_scalar,
+                                                  unpremultiply_scalar,
+                                                  modulate_scalar,
+                                                  blend_scalar,
+                                                  convert_scalar,
+                                                  resize_row_scalar);
+#ifdef SDL_PIXEL_KERNELS_X86
+    // Unpremultiplication and resize work on a single pixel at a time
+    // and gain nothing from wider registers : the AVX2 kernels reuse the SSE2 ones
+    static const sdl_pixel_kernels sse2_kernels(
+        instruction_set::sse2, premultiply_sse2, unpremultiply_sse2, modulate_sse2, blend_sse2, convert_sse2, resize_row_sse2);
+    static const sdl_pixel_kernels avx2_kernels(
+        instruction_set::avx2, premultiply_avx2, unpremultiply_sse2, modulate_avx2, blend_avx2, convert_avx2, resize_row_sse2);
+
+    if ((set == instruction_set::avx2) && SDL_HasAVX2())
+    {
+        return avx2_kernels;
+    }
+    if ((set != instruction_set::scalar) && SDL_HasSSE2())
+    {
+        return sse2_kernels;
+    }
+#else
+    (void)set;
+#endif
+    return scalar_kernels;
+}
+
+/** @brief Get the layout of a pixel format */
+bool sdl_pixel_kernels::get_layout(Uint32 format, pixel_layout& layout)
+{
+    bool   ret    = false;
+    int    bpp    = 0;
+    Uint32 r_mask = 0;
+    Uint32 g_mask = 0;
+    Uint32 b_mask = 0;
+    Uint32 a_mask = 0;
+    if (!SDL_ISPIXELFORMAT_FOURCC(format) && SDL_PixelFormatEnumToMasks(format, &bpp, &r_mask, &g_mask, &b_mask, &a_mask) &&
+        (bpp == 32))
+    {
+        auto get_shift = [](Uint32 mask)
+        {
+            int shift = -1;
+            for (int s = 0; s < 32; s += 8)
+            {
+                if (mask == (0xFFu << s))
+                {
+                    shift = s;
+                }
+            }
+            return shift;
+        };
+        layout.r_shift = get_shift(r_mask);
+        layout.g_shift = get_shift(g_mask);
+        layout.b_shift = get_shift(b_mask);
+        layout.a_shift = get_shift(a_mask);
+        ret            = ((layout.r_shift >= 0) && (layout.g_shift >= 0) && (layout.b_shift >= 0) && (layout.a_shift >= 0));
+    }
+    return ret;
+}
+
+/** @brief Resize an image with bilinear filtering */
+void sdl_pixel_kernels::resize_bilinear(
+    const Uint8* src, int src_pitch, int src_w, int src_h, Uint8* dst, int dst_pitch, int dst_w, int dst_h) const
+{
+    // Empty images have no pixel to sample nor to write
+    if ((src_w > 0) && (src_h > 0) && (dst_w > 0) && (dst_h > 0))
+    {
+        // Source coordinates of the destination columns, sampled at the pixel centers
+        std::vector<int> x0(static_cast<size_t>(dst_w));
+        std::vector<int> x1(static_cast<size_t>(dst_w));
+        std::vector<int> fx(static_cast<size_t>(dst_w));
+        float            x_ratio = static_cast<float>(src_w) / static_cast<float>(dst_w);
+        for (int x = 0; x < dst_w; x++)
+        {
+            float src_x = std::clamp((static_cast<float>(x) + 0.5f) * x_ratio - 0.5f, 0.f, static_cast<float>(src_w - 1));
+            x0[x]       = static_cast<int>(src_x);
+            x1[x]       = std::min(x0[x] + 1, src_w - 1);
+            fx[x]       = static_cast<int>((src_x - static_cast<float>(x0[x])) * 256.f);
+        }
+
+        float y_ratio = static_cast<float>(src_h) / static_cast<float>(dst_h);
+        for (int y = 0; y < dst_h; y++)
+        {
+            float src_y = std::clamp((static_cast<float>(y) + 0.5f) * y_ratio - 0.5f, 0.f, static_cast<float>(src_h - 1));
+            int   y0    = static_cast<int>(src_y);
+            int   y1    = std::min(y0 + 1, src_h - 1);
+            int   fy    = static_cast<int>((src_y - static_cast<float>(y0)) * 256.f);
+            m_resize_row(reinterpret_cast<const Uint32*>(src + y0 * src_pitch),
+                         reinterpret_cast<const Uint32*>(src + y1 * src_pitch),
+                         fy,
+                         x0.data(),
+                         x1.data(),
+                         fx.data(),
+                         reinterpret_cast<Uint32*>(dst + y * dst_pitch),
+                         dst_w);
+        }
+    }
+}
+
+} // namespace sdl
@@ -0,0 +1,140 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SDL_PIXEL_KERNELS_H
+#define SDL_PIXEL_KERNELS_H
+
+#include <SDL2/SDL.h>
+
+namespace sdl
+{
+
+/** @brief Layout of the channels of a 32 bits pixel format with 8 bits channels */
+struct pixel_layout
+{
+    /** @brief Position in bits of the red channel */
+    int r_shift;
+    /** @brief Position in bits of the green channel */
+    int g_shift;
+    /** @brief Position in bits of the blue channel */
+    int b_shift;
+    /** @brief Position in bits of the alpha channel */
+    int a_shift;
+};
+
+/** @brief Pixel processing kernels working on rows of 32 bits pixels with 8 bits channels (ex: RGBA8888, ARGB8888)
+ *         The implementation is selected at runtime among the instruction sets supported by the CPU */
+class sdl_pixel_kernels
+{
+  public:
+    /** @brief Instruction sets of the implementations */
+    enum class instruction_set
+    {
+        /** @brief Portable C++ */
+        scalar,
+        /** @brief x86 SSE2 */
+        sse2,
+        /** @brief x86 AVX2 */
+        avx2
+    };
+
+    /** @brief Get the kernels using the best instruction set supported by the CPU */
+    static const sdl_pixel_kernels& get();
+    /** @brief Get the kernels using an instruction set (scalar kernels if the instruction set is not available) */
+    static const sdl_pixel_kernels& get(instruction_set set);
+
+    /**
+     * @brief Get the layout of a pixel format
+     * @param format Pixel format
+     * @param layout Layout of the channels
+     * @return true if the format is supported by the kernels (32 bits with 8 bits channels including alpha), false otherwise
+     */
+    static bool get_layout(Uint32 format, pixel_layout& layout);
+
+    /** @brief Get the instruction set of the kernels */
+    instruction_set get_instruction_set() const { return m_set; }
+
+    /** @brief Multiply the color channels by the alpha channel */
+    void premultiply(Uint32* pixels, size_t count, int a_shift) const { m_premultiply(pixels, count, a_shift); }
+    /** @brief Divide the color channels by the alpha channel */
+    void unpremultiply(Uint32* pixels, size_t count, int a_shift) const { m_unpremultiply(pixels, count, a_shift); }
+    /** @brief Multiply each channel by the matching channel of a modulation pixel (255 leaves the channel unchanged) */
+    void modulate(Uint32* pixels, size_t count, Uint32 modulation) const { m_modulate(pixels, count, modulation); }
+    /** @brief Blend non premultiplied pixels over other pixels of the same format (SDL_BLENDMODE_BLEND) */
+    void blend(Uint32* dst, const Uint32* src, size_t count, int a_shift) const { m_blend(dst, src, count, a_shift); }
+    /** @brief Convert pixels to another channel layout */
+    void convert(Uint32* dst, const Uint32* src, size_t count, const pixel_layout& src_layout, const pixel_layout& dst_layout) const
+    {
+        m_convert(dst, src, count, src_layout, dst_layout);
+    }
+
+    /**
+     * @brief Resize an image with bilinear filtering
+     * @param src Source pixels
+     * @param src_pitch Number of bytes in a row of source pixels
+     * @param src_w Width of the source image
+     * @param src_h Height of the source image
+     * @param dst Destination pixels
+     * @param dst_pitch Number of bytes in a row of destination pixels
+     * @param dst_w Width of the destination image
+     * @param dst_h Height of the destination image (nothing is written if one of the images is empty)
+     */
+    void resize_bilinear(const Uint8* src, int src_pitch, int src_w, int src_h, Uint8* dst, int dst_pitch, int dst_w, int dst_h) const;
+
+  private:
+    /** @brief Kernel applied in place on a row of pixels with the position of the alpha channel */
+    using alpha_kernel = void (*)(Uint32* pixels, size_t count, int a_shift);
+    /** @brief Modulation kernel */
+    using modulate_kernel = void (*)(Uint32* pixels, size_t count, Uint32 modulation);
+    /** @brief Blending kernel */
+    using blend_kernel = void (*)(Uint32* dst, const Uint32* src, size_t count, int a_shift);
+    /** @brief Conversion kernel */
+    using convert_kernel =
+        void (*)(Uint32* dst, const Uint32* src, size_t count, const pixel_layout& src_layout, const pixel_layout& dst_layout);
+    /** @brief Bilinear interpolation kernel of a destination row */
+    using resize_kernel =
+        void (*)(const Uint32* top, const Uint32* bottom, int fy, const int* x0, const int* x1, const int* fx, Uint32* dst, int dst_w);
+
+    /** @brief Instruction set */
+    instruction_set m_set;
+    /** @brief Premultiplication kernel */
+    alpha_kernel m_premultiply;
+    /** @brief Unpremultiplication kernel */
+    alpha_kernel m_unpremultiply;
+    /** @brief Modulation kernel */
+    modulate_kernel m_modulate;
+    /** @brief Blending kernel */
+    blend_kernel m_blend;
+    /** @brief Conversion kernel */
+    convert_kernel m_convert;
+    /** @brief Bilinear interpolation kernel */
+    resize_kernel m_resize_row;
+
+    /** @brief Constructor */
+    sdl_pixel_kernels(instruction_set set,
+                      alpha_kernel    premultiply,
+                      alpha_kernel    unpremultiply,
+                      modulate_kernel modulate,
+                      blend_kernel    blend,
+                      convert_kernel  convert,
+                      resize_kernel   resize_row);
+};
+
+} // namespace sdl
+
+#endif // SDL_PIXEL_KERNELS_H
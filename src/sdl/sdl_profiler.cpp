@@ -0,0 +1,108 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sdl_profiler.h"
+
+#include <fstream>
+#include <functional>
+#include <thread>
+
+namespace sdl
+{
+
+/** @brief Constructor */
+sdl_profiler::sdl_profiler(size_t capacity)
+    : m_is_enabled(false),
+      m_origin(std::chrono::steady_clock::now()),
+      m_capacity((capacity != 0) ? capacity : 1u),
+      m_events(),
+      m_count(0)
+{
+}
+
+/** @brief Destructor */
+sdl_profiler::~sdl_profiler() { }
+
+/** @brief Enable/disable the recording of the zones */
+void sdl_profiler::set_enabled(bool is_enabled)
+{
+    // The ring buffer is only allocated when needed, the zones see it once the recording is enabled
+    if (is_enabled && m_events.empty())
+    {
+        m_events.resize(m_capacity);
+    }
+    m_is_enabled.store(is_enabled, std::memory_order_release);
+}
+
+/** @brief Get the current timestamp in microseconds */
+Uint64 sdl_profiler::now() const
+{
+    auto elapsed = std::chrono::steady_clock::now() - m_origin;
+    return static_cast<Uint64>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+}
+
+/** @brief Record a zone */
+void sdl_profiler::add(const char* name, Uint64 start, Uint64 duration)
+{
+    // Reserve a slot, the oldest zone is overwritten when the buffer is full
+    size_t index = m_count.fetch_add(1u, std::memory_order_relaxed) % m_events.size();
+
+    event& evt   = m_events[index];
+    evt.name     = name;
+    evt.start    = start;
+    evt.duration = duration;
+    evt.thread   = std::hash<std::thread::id>()(std::this_thread::get_id());
+}
+
+/** @brief Discard the recorded zones */
+void sdl_profiler::clear()
+{
+    m_count.store(0, std::memory_order_relaxed);
+}
+
+/** @brief Save the recorded zones as a Chrome trace JSON file */
+bool sdl_profiler::save(const std::string& file) const
+{
+    bool          ret = false;
+    std::ofstream out(file);
+    if (out)
+    {
+        // Oldest zone first
+        size_t count = m_count.load(std::memory_order_relaxed);
+        size_t size  = ((count < m_events.size()) ? count : m_events.size());
+        size_t first = count - size;
+
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        for (size_t i = 0; i < size; i++)
+        {
+            const event& evt = m_events[(first + i) % m_events.size()];
+            if (i != 0)
+            {
+                out << ",";
+            }
+            out << "\n{\"name\":\"" << evt.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << evt.thread << ",\"ts\":" << evt.start
+                << ",\"dur\":" << evt.duration << "}";
+        }
+        out << "\n]}\n";
+
+        ret = static_cast<bool>(out);
+    }
+    return ret;
+}
+
+} // namespace sdl
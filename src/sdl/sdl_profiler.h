@@ -0,0 +1,140 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SDL_PROFILER_H
+#define SDL_PROFILER_H
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace sdl
+{
+
+/** @brief Frame profiler recording timed zones in a ring buffer which can be exported as a Chrome trace */
+class sdl_profiler
+{
+  public:
+    /** @brief Scoped profiling zone, the zone is recorded on destruction if the profiler was enabled at construction */
+    class zone
+    {
+      public:
+        /**
+         * @brief Constructor
+         * @param profiler Profiler recording the zone
+         * @param name Name of the zone (must be a string literal)
+         */
+        zone(sdl_profiler& profiler, const char* name)
+            : m_profiler(profiler.is_enabled() ? &profiler : nullptr), m_name(name), m_start(m_profiler ? profiler.now() : 0)
+        {
+        }
+        /** @brief Destructor */
+        ~zone()
+        {
+            if (m_profiler)
+            {
+                m_profiler->add(m_name, m_start, m_profiler->now() - m_start);
+            }
+        }
+
+        /** @brief Copy constructor => deleted */
+        zone(const zone& copy) = delete;
+        /** @brief Copy assignment => deleted */
+        zone& operator=(const zone& copy) = delete;
+
+      private:
+        /** @brief Profiler recording the zone (nullptr if disabled) */
+        sdl_profiler* m_profiler;
+        /** @brief Name of the zone */
+        const char* m_name;
+        /** @brief Start timestamp in microseconds */
+        Uint64 m_start;
+    };
+
+    /**
+     * @brief Constructor
+     * @param capacity Maximum number of recorded zones, the oldest zones are overwritten when the buffer is full
+     *                 (the buffer is allocated the first time the recording is enabled)
+     */
+    sdl_profiler(size_t capacity = 65536u);
+    /** @brief Destructor */
+    ~sdl_profiler();
+
+    /** @brief Copy constructor => deleted */
+    sdl_profiler(const sdl_profiler& copy) = delete;
+    /** @brief Copy assignment => deleted */
+    sdl_profiler& operator=(const sdl_profiler& copy) = delete;
+
+    /** @brief Enable/disable the recording of the zones (disabled by default) */
+    void set_enabled(bool is_enabled);
+    /** @brief Indicate if the recording of the zones is enabled */
+    bool is_enabled() const { return m_is_enabled.load(std::memory_order_acquire); }
+
+    /** @brief Get the current timestamp in microseconds */
+    Uint64 now() const;
+
+    /**
+     * @brief Record a zone
+     * @param name Name of the zone (must be a string literal)
+     * @param start Start timestamp in microseconds
+     * @param duration Duration in microseconds
+     */
+    void add(const char* name, Uint64 start, Uint64 duration);
+
+    /** @brief Discard the recorded zones */
+    void clear();
+
+    /**
+     * @brief Save the recorded zones as a Chrome trace JSON file (chrome://tracing, Perfetto)
+     *        No zone must be recorded during the save
+     * @param file Path to the file
+     * @return true if the file has been saved, false otherwise
+     */
+    bool save(const std::string& file) const;
+
+  private:
+    /** @brief Recorded zone */
+    struct event
+    {
+        /** @brief Name */
+        const char* name;
+        /** @brief Start timestamp in microseconds */
+        Uint64 start;
+        /** @brief Duration in microseconds */
+        Uint64 duration;
+        /** @brief Identifier of the thread which recorded the zone */
+        size_t thread;
+    };
+
+    /** @brief Indicate if the recording is enabled */
+    std::atomic<bool> m_is_enabled;
+    /** @brief Time origin of the timestamps */
+    std::chrono::steady_clock::time_point m_origin;
+    /** @brief Maximum number of recorded zones */
+    size_t m_capacity;
+    /** @brief Ring buffer of recorded zones */
+    std::vector<event> m_events;
+    /** @brief Total number of recorded zones */
+    std::atomic<size_t> m_count;
+};
+
+} // namespace sdl
+
+#endif // SDL_PROFILER_H
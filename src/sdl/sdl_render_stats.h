@@ -0,0 +1,71 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SDL_RENDER_STATS_H
+#define SDL_RENDER_STATS_H
+
+#include <SDL2/SDL.h>
+
+namespace sdl
+{
+
+/** @brief Rendering statistics of a frame */
+struct render_stats
+{
+    /** @brief Number of clear calls */
+    Uint64 clears;
+    /** @brief Number of point drawing calls */
+    Uint64 points;
+    /** @brief Number of line drawing calls */
+    Uint64 lines;
+    /** @brief Number of rectangle drawing calls */
+    Uint64 rects;
+    /** @brief Number of rectangle filling calls */
+    Uint64 fills;
+    /** @brief Number of texture copy calls */
+    Uint64 copies;
+    /** @brief Number of geometry calls (batched texture copies) */
+    Uint64 geometries;
+    /** @brief Number of texture copies submitted through geometry calls */
+    Uint64 batched_copies;
+    /** @brief Number of geometry calls submitting batched texture copies (batched_copies / batches copies per call) */
+    Uint64 batches;
+    /** @brief Number of times a texture different from the previous one has been used for drawing */
+    Uint64 texture_binds;
+    /** @brief Number of render target switches */
+    Uint64 target_switches;
+    /** @brief Number of state changes skipped because they changed nothing */
+    Uint64 skipped_state_changes;
+    /** @brief Number of textures created */
+    Uint64 textures_created;
+    /** @brief Number of textures destroyed */
+    Uint64 textures_destroyed;
+    /** @brief Number of pixels written by clears, rectangle fills and texture copies */
+    Uint64 pixels_filled;
+    /** @brief Number of bytes uploaded to textures */
+    Uint64 bytes_uploaded;
+    /** @brief Estimated memory used by the existing textures in bytes (not reset between frames) */
+    Uint64 texture_memory;
+
+    /** @brief Get the total number of draw calls */
+    Uint64 get_draw_calls() const { return (clears + points + lines + rects + fills + copies + geometries); }
+};
+
+} // namespace sdl
+
+#endif // SDL_RENDER_STATS_H
@@ -19,6 +19,11 @@ along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
 #include "sdl_renderer.h"
 
 #include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <tuple>
 
 namespace sdl
 {
@@ -26,11 +31,49 @@ namespace sdl
 /** @brief Destructor */
 sdl_renderer::~sdl_renderer()
 {
+    // Destroy the unused textures of the pool while the renderer is alive
+    m_texture_pool->trim();
+
     SDL_DestroyRenderer(m_handle);
 }
 
 /** @brief Constructor */
-sdl_renderer::sdl_renderer(SDL_Renderer* handle) : m_handle(handle) { }
+sdl_renderer::sdl_renderer(SDL_Renderer* handle)
+    : m_handle(handle),
+      m_texture_stack(),
+      m_target(),
+      m_draw_color{0, 0, 0, 0},
+      m_blend_mode(SDL_BLENDMODE_NONE),
+      m_sdl_state{false, false, false, nullptr, {0, 0, 0, 0}, SDL_BLENDMODE_NONE, false, {0, 0, 0, 0}, false, {0, 0, 0, 0}},
+      m_skipped_state_changes(0),
+      m_stats(std::make_shared<render_stats>()),
+      m_last_stats(),
+      m_bound_texture(),
+      m_profiler(),
+      m_sprite_batch(handle),
+      m_is_batching(false),
+      m_is_deferred(false),
+      m_layer(0),
+      m_commands(),
+      m_left_targets(),
+      m_target_sequence(0),
+      m_merged_rects(),
+      m_geometry_vertices(),
+      m_geometry_indices(),
+      m_merged_indices(),
+      m_texture_pool(sdl_texture_pool::create(*this))
+{
+    // Get the initial drawing state
+    SDL_GetRenderDrawColor(m_handle, &m_draw_color.r, &m_draw_color.g, &m_draw_color.b, &m_draw_color.a);
+    SDL_GetRenderDrawBlendMode(m_handle, &m_blend_mode);
+
+    // A new renderer draws on the window without clipping nor viewport
+    m_sdl_state.is_valid          = true;
+    m_sdl_state.is_clip_valid     = true;
+    m_sdl_state.is_viewport_valid = true;
+    m_sdl_state.draw_color        = m_draw_color;
+    m_sdl_state.blend_mode        = m_blend_mode;
+}
 
 /** @brief Get information about a rendering context */
 bool sdl_renderer::get_info(SDL_RendererInfo& info) const
@@ -45,8 +88,7 @@ texture sdl_renderer::create_texture(Uint32 format, int access, int w, int h)
     SDL_Texture* texture = SDL_CreateTexture(m_handle, format, access, w, h);
     if (texture)
     {
-        auto p = new sdl_texture(texture);
-        instance.reset(p);
+        instance = make_texture(texture, 0);
     }
     return instance;
 }
@@ -58,8 +100,7 @@ texture sdl_renderer::create_texture(const surface& surface)
     SDL_Texture* texture = SDL_CreateTextureFromSurface(m_handle, surface->m_handle);
     if (texture)
     {
-        auto p = new sdl_texture(texture);
-        instance.reset(p);
+        instance = make_texture(texture, static_cast<Uint64>(surface->m_handle->h) * static_cast<Uint64>(surface->m_handle->pitch));
     }
     return instance;
 }
@@ -71,8 +112,8 @@ texture sdl_renderer::create_texture(const std::string& file)
     SDL_Texture* texture = IMG_LoadTexture(m_handle, file.c_str());
     if (texture)
     {
-        auto p = new sdl_texture(texture);
-        instance.reset(p);
+        instance                 = make_texture(texture, 0);
+        m_stats->bytes_uploaded += instance->get_memory_size();
     }
     return instance;
 }
@@ -80,13 +121,36 @@ texture sdl_renderer::create_texture(const std::string& file)
 /** @brief Present the renderer to update the screen */
 void sdl_renderer::present()
 {
+    if (m_is_deferred)
+    {
+        flush_commands();
+    }
+    flush_batch();
     SDL_RenderPresent(m_handle);
+
+    // Start statistics of the next frame
+    m_last_stats            = *m_stats;
+    *m_stats                = render_stats();
+    m_stats->texture_memory = m_last_stats.texture_memory;
+    m_bound_texture.reset();
 }
 
 /** @brief Clear the contents of the renderer */
 bool sdl_renderer::clear()
 {
-    return (SDL_RenderClear(m_handle) == 0);
+    bool ret = true;
+    if (m_is_deferred)
+    {
+        m_commands.push_back(make_command(command_type::clear));
+    }
+    else
+    {
+        flush_batch();
+        ret = (SDL_RenderClear(m_handle) == 0);
+        m_stats->clears++;
+        count_pixels(nullptr);
+    }
+    return ret;
 }
 
 /** @brief Get the rectangle in which the renderer can draw */
@@ -100,13 +164,13 @@ SDL_Rect sdl_renderer::get_draw_rect() const
 /** @brief Set the texture as the current target for drawing */
 bool sdl_renderer::set_target(texture& texture)
 {
-    return (SDL_SetRenderTarget(m_handle, texture->m_handle) == 0);
+    return change_target(texture);
 }
 
 /** @brief Restore the renderer as the current target for drawing */
 bool sdl_renderer::restore_target()
 {
-    return (SDL_SetRenderTarget(m_handle, nullptr) == 0);
+    return change_target(nullptr);
 }
 
 /** @brief Push a texture as the current target for drawing on the texture stack */
@@ -115,7 +179,7 @@ bool sdl_renderer::push_texture(texture& texture)
     bool ret = set_target(texture);
     if (ret)
     {
-        m_texture_stack.push(texture);
+        m_texture_stack.push_back(texture);
     }
     return ret;
 }
@@ -125,14 +189,14 @@ bool sdl_renderer::pop_texture()
     bool ret = false;
     if (!m_texture_stack.empty())
     {
-        m_texture_stack.pop();
+        m_texture_stack.pop_back();
         if (m_texture_stack.empty())
         {
             ret = restore_target();
         }
         else
         {
-            ret = set_target(m_texture_stack.top());
+            ret = set_target(m_texture_stack.back());
         }
     }
     return ret;
@@ -141,7 +205,16 @@ bool sdl_renderer::pop_texture()
 /** @brief Set the blend mode */
 bool sdl_renderer::set_blend_mode(SDL_BlendMode blend_mode)
 {
-    return (SDL_SetRenderDrawBlendMode(m_handle, blend_mode) == 0);
+    bool ret = true;
+    if (!m_is_deferred)
+    {
+        ret = apply_blend_mode(blend_mode);
+    }
+    if (ret)
+    {
+        m_blend_mode = blend_mode;
+    }
+    return ret;
 }
 
 /** @brief Set the draw color */
@@ -153,7 +226,82 @@ bool sdl_renderer::set_draw_color(const SDL_Color& color)
 /** @brief Set the draw color */
 bool sdl_renderer::set_draw_color(Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
-    return (SDL_SetRenderDrawColor(m_handle, r, g, b, a) == 0);
+    bool      ret   = true;
+    SDL_Color color = {r, g, b, a};
+    if (!m_is_deferred)
+    {
+        ret = apply_draw_color(color);
+    }
+    if (ret)
+    {
+        m_draw_color = color;
+    }
+    return ret;
+}
+
+/** @brief Set the clip rectangle of the current target (nullptr to disable clipping) */
+bool sdl_renderer::set_clip_rect(const SDL_Rect* rect)
+{
+    bool ret = true;
+    if (m_sdl_state.is_valid && m_sdl_state.is_clip_valid && (m_sdl_state.target == m_target) &&
+        (m_sdl_state.is_clipping == (rect != nullptr)) && (!rect || SDL_RectEquals(rect, &m_sdl_state.clip_rect)))
+    {
+        m_skipped_state_changes++;
+        m_stats->skipped_state_changes++;
+    }
+    else
+    {
+        // Clipping is not recorded in deferred mode, the pending operations are drawn with the previous clip rectangle
+        prepare_immediate();
+        ret = (SDL_RenderSetClipRect(m_handle, rect) == 0);
+        if (ret)
+        {
+            m_sdl_state.is_clip_valid = true;
+            m_sdl_state.is_clipping   = (rect != nullptr);
+            m_sdl_state.clip_rect     = (rect ? *rect : SDL_Rect{0, 0, 0, 0});
+        }
+    }
+    return ret;
+}
+
+/** @brief Set the viewport of the current target (nullptr to use the whole target) */
+bool sdl_renderer::set_viewport(const SDL_Rect* rect)
+{
+    bool ret = true;
+    if (m_sdl_state.is_valid && m_sdl_state.is_viewport_valid && (m_sdl_state.target == m_target) &&
+        (m_sdl_state.has_viewport == (rect != nullptr)) && (!rect || SDL_RectEquals(rect, &m_sdl_state.viewport)))
+    {
+        m_skipped_state_changes++;
+        m_stats->skipped_state_changes++;
+    }
+    else
+    {
+        // Viewport is not recorded in deferred mode, the pending operations are drawn with the previous viewport
+        prepare_immediate();
+        ret = (SDL_RenderSetViewport(m_handle, rect) == 0);
+        if (ret)
+        {
+            m_sdl_state.is_viewport_valid = true;
+            m_sdl_state.has_viewport      = (rect != nullptr);
+            m_sdl_state.viewport          = (rect ? *rect : SDL_Rect{0, 0, 0, 0});
+        }
+    }
+    return ret;
+}
+
+/** @brief Forget the state known by the renderer so that it is sent again to SDL (ex: after a device reset) */
+void sdl_renderer::invalidate_state()
+{
+    flush_batch();
+
+    // Send the current state
+    m_sdl_state.is_valid          = false;
+    m_sdl_state.is_clip_valid     = false;
+    m_sdl_state.is_viewport_valid = false;
+    apply_target(m_target);
+    apply_draw_color(m_draw_color);
+    apply_blend_mode(m_blend_mode);
+    m_sdl_state.is_valid = true;
 }
 
 /** @brief Draw a point */
@@ -165,6 +313,8 @@ bool sdl_renderer::draw_point(const SDL_Point& p)
 /** @brief Draw a point */
 bool sdl_renderer::draw_point(int x, int y)
 {
+    prepare_immediate();
+    m_stats->points++;
     return (SDL_RenderDrawPoint(m_handle, x, y) == 0);
 }
 
@@ -177,6 +327,8 @@ bool sdl_renderer::draw_points(const std::vector<SDL_Point>& points)
 /** @brief Draw a list of points */
 bool sdl_renderer::draw_points(const SDL_Point* points, int count)
 {
+    prepare_immediate();
+    m_stats->points++;
     return (SDL_RenderDrawPoints(m_handle, points, count) == 0);
 }
 
@@ -189,6 +341,8 @@ bool sdl_renderer::draw_line(const SDL_Point& p1, const SDL_Point& p2)
 /** @brief Draw a point */
 bool sdl_renderer::draw_line(int x1, int y1, int x2, int y2)
 {
+    prepare_immediate();
+    m_stats->lines++;
     return (SDL_RenderDrawLine(m_handle, x1, y1, x2, y2) == 0);
 }
 
@@ -201,19 +355,50 @@ bool sdl_renderer::draw_lines(const std::vector<SDL_Point>& points)
 /** @brief Draw lines between points */
 bool sdl_renderer::draw_lines(const SDL_Point* points, int count)
 {
+    prepare_immediate();
+    m_stats->lines++;
     return (SDL_RenderDrawLines(m_handle, points, count) == 0);
 }
 
 /** @brief Draw a rectangle */
 bool sdl_renderer::draw_rect(const SDL_Rect& rect)
 {
-    return (SDL_RenderDrawRect(m_handle, &rect) == 0);
+    bool ret = true;
+    if (m_is_deferred)
+    {
+        command cmd      = make_command(command_type::draw_rect);
+        cmd.has_dst_rect = true;
+        cmd.dst_rect     = rect;
+        m_commands.push_back(cmd);
+    }
+    else
+    {
+        flush_batch();
+        ret = (SDL_RenderDrawRect(m_handle, &rect) == 0);
+        m_stats->rects++;
+    }
+    return ret;
 }
 
 /** @brief Fill a rectangle */
 bool sdl_renderer::fill_rect(const SDL_Rect& rect)
 {
-    return (SDL_RenderFillRect(m_handle, &rect) == 0);
+    bool ret = true;
+    if (m_is_deferred)
+    {
+        command cmd      = make_command(command_type::fill_rect);
+        cmd.has_dst_rect = true;
+        cmd.dst_rect     = rect;
+        m_commands.push_back(cmd);
+    }
+    else
+    {
+        flush_batch();
+        ret = (SDL_RenderFillRect(m_handle, &rect) == 0);
+        m_stats->fills++;
+        count_pixels(&rect);
+    }
+    return ret;
 }
 
 /** @brief Draw a list of rectangles */
@@ -225,7 +410,21 @@ bool sdl_renderer::draw_rects(const std::vector<SDL_Rect>& rects)
 /** @brief Draw a list of rectangles */
 bool sdl_renderer::draw_rects(const SDL_Rect* rects, int count)
 {
-    return (SDL_RenderDrawRects(m_handle, rects, count) == 0);
+    bool ret = true;
+    if (m_is_deferred)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            ret = draw_rect(rects[i]) && ret;
+        }
+    }
+    else
+    {
+        flush_batch();
+        ret = (SDL_RenderDrawRects(m_handle, rects, count) == 0);
+        m_stats->rects++;
+    }
+    return ret;
 }
 
 /** @brief Fill a list of rectangles */
@@ -237,13 +436,48 @@ bool sdl_renderer::fill_rects(const std::vector<SDL_Rect>& rects)
 /** @brief Fill a list of rectangles */
 bool sdl_renderer::fill_rects(const SDL_Rect* rects, int count)
 {
-    return (SDL_RenderFillRects(m_handle, rects, count) == 0);
+    bool ret = true;
+    if (m_is_deferred)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            ret = fill_rect(rects[i]) && ret;
+        }
+    }
+    else
+    {
+        flush_batch();
+        ret = (SDL_RenderFillRects(m_handle, rects, count) == 0);
+        m_stats->fills++;
+        for (int i = 0; i < count; i++)
+        {
+            count_pixels(&rects[i]);
+        }
+    }
+    return ret;
 }
 
 /** @brief Draw a texture */
 bool sdl_renderer::copy(texture& texture, const SDL_Rect* src_rect, const SDL_Rect* dst_rect)
 {
-    return (SDL_RenderCopy(m_handle, texture->m_handle, src_rect, dst_rect) == 0);
+    bool ret = false;
+    if (m_is_deferred)
+    {
+        ret = copy(texture, src_rect, dst_rect, 0., nullptr, SDL_FLIP_NONE);
+    }
+    else if (m_is_batching && dst_rect)
+    {
+        ret = batch_copy(texture, src_rect, *dst_rect, 0., nullptr, SDL_FLIP_NONE);
+    }
+    else
+    {
+        flush_batch();
+        ret = (SDL_RenderCopy(m_handle, texture->m_handle, src_rect, dst_rect) == 0);
+        m_stats->copies++;
+        count_bind(texture);
+        count_pixels(dst_rect);
+    }
+    return ret;
 }
 
 /** @brief Draw a texture */
@@ -254,7 +488,599 @@ bool sdl_renderer::copy(texture&               texture,
                         const SDL_Point*       center,
                         const SDL_RendererFlip flip)
 {
-    return (SDL_RenderCopyEx(m_handle, texture->m_handle, src_rect, dst_rect, angle, center, flip) == 0);
+    bool ret = false;
+    if (m_is_deferred)
+    {
+        command cmd      = make_command(command_type::copy);
+        cmd.source       = texture;
+        cmd.has_src_rect = (src_rect != nullptr);
+        cmd.src_rect     = (src_rect ? *src_rect : SDL_Rect{0, 0, 0, 0});
+        cmd.has_dst_rect = (dst_rect != nullptr);
+        cmd.dst_rect     = (dst_rect ? *dst_rect : SDL_Rect{0, 0, 0, 0});
+        cmd.angle        = angle;
+        cmd.has_center   = (center != nullptr);
+        cmd.center       = (center ? *center : SDL_Point{0, 0});
+        cmd.flip         = flip;
+        m_commands.push_back(cmd);
+        ret = true;
+    }
+    else if (m_is_batching && dst_rect)
+    {
+        ret = batch_copy(texture, src_rect, *dst_rect, angle, center, flip);
+    }
+    else
+    {
+        flush_batch();
+        ret = (SDL_RenderCopyEx(m_handle, texture->m_handle, src_rect, dst_rect, angle, center, flip) == 0);
+        m_stats->copies++;
+        count_bind(texture);
+        count_pixels(dst_rect);
+    }
+    return ret;
+}
+
+/** @brief Draw textured triangles */
+bool sdl_renderer::draw_geometry(texture& texture, const SDL_Vertex* vertices, int vertex_count, const int* indices, int index_count)
+{
+    bool ret = false;
+    if (vertices && indices && (vertex_count > 0) && (index_count > 0))
+    {
+        if (m_is_deferred)
+        {
+            command cmd      = make_command(command_type::geometry);
+            cmd.source       = texture;
+            cmd.first_vertex = m_geometry_vertices.size();
+            cmd.vertex_count = static_cast<size_t>(vertex_count);
+            cmd.first_index  = m_geometry_indices.size();
+            cmd.index_count  = static_cast<size_t>(index_count);
+            m_geometry_vertices.insert(m_geometry_vertices.end(), vertices, vertices + vertex_count);
+            m_geometry_indices.insert(m_geometry_indices.end(), indices, indices + index_count);
+            m_commands.push_back(cmd);
+            ret = true;
+        }
+        else
+        {
+            flush_batch();
+            SDL_Texture* handle = (texture ? texture->m_handle : nullptr);
+            ret                 = (SDL_RenderGeometry(m_handle, handle, vertices, vertex_count, indices, index_count) == 0);
+            m_stats->geometries++;
+            count_bind(texture);
+        }
+    }
+    return ret;
+}
+
+/** @brief Enable/disable the batching of the texture copies */
+void sdl_renderer::set_batching(bool is_enabled)
+{
+    if (!is_enabled)
+    {
+        flush_batch();
+    }
+    m_is_batching = is_enabled;
+}
+
+/** @brief Enable/disable the deferred rendering mode */
+void sdl_renderer::set_deferred(bool is_enabled)
+{
+    if (is_enabled != m_is_deferred)
+    {
+        if (is_enabled)
+        {
+            flush_batch();
+        }
+        else
+        {
+            flush_commands();
+        }
+        m_is_deferred = is_enabled;
+    }
+}
+
+/** @brief Draw the pending texture copies */
+void sdl_renderer::flush_batch()
+{
+    if (!m_sprite_batch.is_empty())
+    {
+        m_stats->geometries++;
+        m_stats->batches++;
+        m_stats->batched_copies += m_sprite_batch.get_quad_count();
+        m_sprite_batch.flush();
+    }
+}
+
+/** @brief Add a texture copy to the batch */
+bool sdl_renderer::batch_copy(texture&               texture,
+                              const SDL_Rect*        src_rect,
+                              const SDL_Rect&        dst_rect,
+                              const double           angle,
+                              const SDL_Point*       center,
+                              const SDL_RendererFlip flip)
+{
+    // Flush here instead of inside the batch so that every geometry call is counted
+    if (texture != m_sprite_batch.get_texture())
+    {
+        flush_batch();
+        count_bind(texture);
+    }
+    count_pixels(&dst_rect);
+    return m_sprite_batch.add(texture, src_rect, dst_rect, angle, center, flip);
+}
+
+/** @brief Wrap a newly created texture */
+texture sdl_renderer::make_texture(SDL_Texture* handle, Uint64 uploaded_bytes)
+{
+    auto    p = new sdl_texture(handle, m_stats);
+    texture instance(p);
+
+    m_stats->textures_created++;
+    m_stats->bytes_uploaded += uploaded_bytes;
+    m_stats->texture_memory += instance->get_memory_size();
+
+    return instance;
+}
+
+/** @brief Count the use of a texture for drawing */
+void sdl_renderer::count_bind(const texture& texture)
+{
+    if (texture != m_bound_texture)
+    {
+        m_stats->texture_binds++;
+        m_bound_texture = texture;
+    }
+}
+
+/** @brief Count the pixels written in a rectangle of the current target (nullptr for the whole target) */
+void sdl_renderer::count_pixels(const SDL_Rect* rect)
+{
+    SDL_Rect area;
+    if (rect)
+    {
+        area = *rect;
+    }
+    else if (m_sdl_state.target)
+    {
+        area = m_sdl_state.target->get_size();
+    }
+    else
+    {
+        area = get_draw_rect();
+    }
+    if ((area.w > 0) && (area.h > 0))
+    {
+        m_stats->pixels_filled += static_cast<Uint64>(area.w) * static_cast<Uint64>(area.h);
+    }
+}
+
+/** @brief Change the current target */
+bool sdl_renderer::change_target(const texture& target)
+{
+    bool ret = true;
+    if (m_is_deferred)
+    {
+        // Remember when a target is left so that it can be drawn before being used as a texture
+        if (target != m_target)
+        {
+            if (m_target)
+            {
+                m_left_targets[m_target.get()] = m_target_sequence++;
+            }
+            if (target)
+            {
+                m_left_targets.erase(target.get());
+            }
+        }
+    }
+    else
+    {
+        ret = apply_target(target);
+    }
+    if (ret)
+    {
+        m_target = target;
+    }
+    return ret;
+}
+
+/** @brief Send the target to SDL if it has changed */
+bool sdl_renderer::apply_target(const texture& target)
+{
+    bool ret = true;
+    if (m_sdl_state.is_valid && (target == m_sdl_state.target))
+    {
+        m_skipped_state_changes++;
+        m_stats->skipped_state_changes++;
+    }
+    else
+    {
+        flush_batch();
+        ret = (SDL_SetRenderTarget(m_handle, (target ? target->m_handle : nullptr)) == 0);
+        m_stats->target_switches++;
+        if (ret)
+        {
+            // SDL resets the clip rectangle and the viewport on target change
+            m_sdl_state.target            = target;
+            m_sdl_state.is_clip_valid     = false;
+            m_sdl_state.is_viewport_valid = false;
+        }
+    }
+    return ret;
+}
+
+/** @brief Send the draw color to SDL if it has changed */
+bool sdl_renderer::apply_draw_color(const SDL_Color& color)
+{
+    bool ret = true;
+    if (m_sdl_state.is_valid && (color.r == m_sdl_state.draw_color.r) && (color.g == m_sdl_state.draw_color.g) &&
+        (color.b == m_sdl_state.draw_color.b) && (color.a == m_sdl_state.draw_color.a))
+    {
+        m_skipped_state_changes++;
+        m_stats->skipped_state_changes++;
+    }
+    else
+    {
+        ret = (SDL_SetRenderDrawColor(m_handle, color.r, color.g, color.b, color.a) == 0);
+        if (ret)
+        {
+            m_sdl_state.draw_color = color;
+        }
+    }
+    return ret;
+}
+
+/** @brief Send the blend mode to SDL if it has changed */
+bool sdl_renderer::apply_blend_mode(SDL_BlendMode blend_mode)
+{
+    bool ret = true;
+    if (m_sdl_state.is_valid && (blend_mode == m_sdl_state.blend_mode))
+    {
+        m_skipped_state_changes++;
+        m_stats->skipped_state_changes++;
+    }
+    else
+    {
+        ret = (SDL_SetRenderDrawBlendMode(m_handle, blend_mode) == 0);
+        if (ret)
+        {
+            m_sdl_state.blend_mode = blend_mode;
+        }
+    }
+    return ret;
+}
+
+/** @brief Initialize a deferred command with the current state */
+sdl_renderer::command sdl_renderer::make_command(command_type type) const
+{
+    command cmd;
+    cmd.type         = type;
+    cmd.target       = m_target;
+    cmd.target_rank  = 0;
+    cmd.layer        = m_layer;
+    cmd.blend_mode   = m_blend_mode;
+    cmd.color        = m_draw_color;
+    cmd.source       = nullptr;
+    cmd.has_src_rect = false;
+    cmd.src_rect     = {0, 0, 0, 0};
+    cmd.has_dst_rect = false;
+    cmd.dst_rect     = {0, 0, 0, 0};
+    cmd.angle        = 0.;
+    cmd.has_center   = false;
+    cmd.center       = {0, 0};
+    cmd.flip         = SDL_FLIP_NONE;
+    cmd.first_vertex = 0;
+    cmd.vertex_count = 0;
+    cmd.first_index  = 0;
+    cmd.index_count  = 0;
+    cmd.has_bounds   = false;
+    cmd.bounds       = {0, 0, 0, 0};
+    return cmd;
+}
+
+/** @brief Compute the bounding box of the area drawn by a deferred command */
+bool sdl_renderer::get_bounds(const command& cmd, SDL_Rect& bounds) const
+{
+    bool ret = false;
+    if ((cmd.type == command_type::fill_rect) || (cmd.type == command_type::draw_rect))
+    {
+        bounds = cmd.dst_rect;
+        ret    = true;
+    }
+    else if ((cmd.type == command_type::copy) && cmd.has_dst_rect)
+    {
+        bounds = cmd.dst_rect;
+        ret    = true;
+        if (cmd.angle != 0.)
+        {
+            // Rotate the corners of the destination around the center of rotation
+            const SDL_Rect& dst      = cmd.dst_rect;
+            double          center_x = dst.x + (cmd.has_center ? cmd.center.x : dst.w / 2.);
+            double          center_y = dst.y + (cmd.has_center ? cmd.center.y : dst.h / 2.);
+            double          angle    = cmd.angle * 3.14159265358979323846 / 180.;
+            double          cos_a    = std::cos(angle);
+            double          sin_a    = std::sin(angle);
+            double          left     = center_x;
+            double          top      = center_y;
+            double          right    = center_x;
+            double          bottom   = center_y;
+            for (int corner = 0; corner < 4; corner++)
+            {
+                double x         = dst.x + (((corner & 1) != 0) ? dst.w : 0) - center_x;
+                double y         = dst.y + (((corner & 2) != 0) ? dst.h : 0) - center_y;
+                double rotated_x = center_x + x * cos_a - y * sin_a;
+                double rotated_y = center_y + x * sin_a + y * cos_a;
+                left             = std::min(left, rotated_x);
+                top              = std::min(top, rotated_y);
+                right            = std::max(right, rotated_x);
+                bottom           = std::max(bottom, rotated_y);
+            }
+            bounds.x = static_cast<int>(std::floor(left)) - 1;
+            bounds.y = static_cast<int>(std::floor(top)) - 1;
+            bounds.w = static_cast<int>(std::ceil(right)) + 1 - bounds.x;
+            bounds.h = static_cast<int>(std::ceil(bottom)) + 1 - bounds.y;
+        }
+    }
+    else if ((cmd.type == command_type::geometry) && (cmd.vertex_count != 0))
+    {
+        const SDL_Vertex* vertices = &m_geometry_vertices[cmd.first_vertex];
+        float             left     = vertices[0].position.x;
+        float             top      = vertices[0].position.y;
+        float             right    = vertices[0].position.x;
+        float             bottom   = vertices[0].position.y;
+        for (size_t i = 1; i < cmd.vertex_count; i++)
+        {
+            left   = std::min(left, vertices[i].position.x);
+            top    = std::min(top, vertices[i].position.y);
+            right  = std::max(right, vertices[i].position.x);
+            bottom = std::max(bottom, vertices[i].position.y);
+        }
+        bounds.x = static_cast<int>(std::floor(left)) - 1;
+        bounds.y = static_cast<int>(std::floor(top)) - 1;
+        bounds.w = static_cast<int>(std::ceil(right)) + 1 - bounds.x;
+        bounds.h = static_cast<int>(std::ceil(bottom)) + 1 - bounds.y;
+        ret      = true;
+    }
+    else
+    {
+        // Clears and copies to the whole target cover everything
+    }
+    return ret;
+}
+
+/** @brief Order of the deferred commands putting the ones which can be merged next to each other */
+bool sdl_renderer::is_state_before(const command& a, const command& b)
+{
+    bool ret = false;
+    if (a.type != b.type)
+    {
+        ret = (a.type < b.type);
+    }
+    else if ((a.type == command_type::copy) || (a.type == command_type::geometry))
+    {
+        // The blend mode of a copy is the one of its texture
+        ret = std::less<const sdl_texture*>()(a.source.get(), b.source.get());
+    }
+    else
+    {
+        ret = (std::tie(a.blend_mode, a.color.r, a.color.g, a.color.b, a.color.a) <
+               std::tie(b.blend_mode, b.color.r, b.color.g, b.color.b, b.color.a));
+    }
+    return ret;
+}
+
+/** @brief Sort, merge and draw the recorded commands */
+bool sdl_renderer::flush_commands()
+{
+    bool ret = true;
+
+    if (!m_commands.empty())
+    {
+        // Targets are drawn in the order they have been left for the last time so that a texture is complete
+        // before being copied to another target, the targets which are still in use are drawn last
+        for (auto& cmd : m_commands)
+        {
+            auto iter_target = m_left_targets.find(cmd.target.get());
+            if (iter_target != m_left_targets.end())
+            {
+                cmd.target_rank = iter_target->second;
+            }
+            else
+            {
+                cmd.target_rank = (cmd.target ? (UINT64_MAX - 1u) : UINT64_MAX);
+            }
+            cmd.has_bounds = get_bounds(cmd, cmd.bounds);
+        }
+
+        // Sort by target and layer, the submission order is kept inside a layer
+        std::stable_sort(m_commands.begin(),
+                         m_commands.end(),
+                         [](const command& a, const command& b)
+                         { return (std::tie(a.target_rank, a.layer) < std::tie(b.target_rank, b.layer)); });
+
+        // Inside a layer, the commands of a run in which no command overlaps another give the same result in any order,
+        // sort them by state so that the ones using the same texture are merged whatever their submission order
+        size_t run_begin = 0;
+        for (size_t i = 0; i <= m_commands.size(); i++)
+        {
+            bool is_run_end = ((i == m_commands.size()) || ((i - run_begin) >= MAX_REORDERED_COMMANDS));
+            if (!is_run_end)
+            {
+                const command& cmd   = m_commands[i];
+                const command& first = m_commands[run_begin];
+                is_run_end           = ((cmd.target_rank != first.target_rank) || (cmd.layer != first.layer) || !cmd.has_bounds ||
+                                        !first.has_bounds);
+                for (size_t j = run_begin; (j < i) && !is_run_end; j++)
+                {
+                    is_run_end = (SDL_HasIntersection(&cmd.bounds, &m_commands[j].bounds) == SDL_TRUE);
+                }
+            }
+            if (is_run_end)
+            {
+                std::stable_sort(m_commands.begin() + static_cast<std::ptrdiff_t>(run_begin),
+                                 m_commands.begin() + static_cast<std::ptrdiff_t>(i),
+                                 &sdl_renderer::is_state_before);
+                run_begin = i;
+            }
+        }
+
+        // Draw the commands, merging the adjacent commands which can be drawn with a single call
+        for (size_t i = 0; i < m_commands.size();)
+        {
+            const command& cmd = m_commands[i];
+
+            // Look for compatible commands
+            size_t end = i + 1u;
+            while ((end < m_commands.size()) && (cmd.type != command_type::clear))
+            {
+                const command& next = m_commands[end];
+                if ((next.target != cmd.target) || (next.type != cmd.type))
+                {
+                    break;
+                }
+                // Copies and geometries only depend on their texture, the other commands on the blend mode and the draw color
+                bool is_same_state = false;
+                if ((cmd.type == command_type::copy) || (cmd.type == command_type::geometry))
+                {
+                    is_same_state = (next.source == cmd.source);
+                }
+                else
+                {
+                    is_same_state = ((next.blend_mode == cmd.blend_mode) && (next.color.r == cmd.color.r) &&
+                                     (next.color.g == cmd.color.g) && (next.color.b == cmd.color.b) && (next.color.a == cmd.color.a));
+                }
+                if (!is_same_state)
+                {
+                    break;
+                }
+                end++;
+            }
+
+            // Select target
+            ret = apply_target(cmd.target) && ret;
+
+            // Draw
+            if (cmd.type == command_type::copy)
+            {
+                for (size_t j = i; j < end; j++)
+                {
+                    command& copy_cmd = m_commands[j];
+                    if (copy_cmd.has_dst_rect)
+                    {
+                        ret = batch_copy(copy_cmd.source,
+                                         (copy_cmd.has_src_rect ? &copy_cmd.src_rect : nullptr),
+                                         copy_cmd.dst_rect,
+                                         copy_cmd.angle,
+                                         (copy_cmd.has_center ? &copy_cmd.center : nullptr),
+                                         copy_cmd.flip) &&
+                              ret;
+                    }
+                    else
+                    {
+                        flush_batch();
+                        m_stats->copies++;
+                        count_bind(copy_cmd.source);
+                        count_pixels(nullptr);
+                        ret = (SDL_RenderCopyEx(m_handle,
+                                                copy_cmd.source->m_handle,
+                                                (copy_cmd.has_src_rect ? &copy_cmd.src_rect : nullptr),
+                                                nullptr,
+                                                copy_cmd.angle,
+                                                (copy_cmd.has_center ? &copy_cmd.center : nullptr),
+                                                copy_cmd.flip) == 0) &&
+                              ret;
+                    }
+                }
+                flush_batch();
+            }
+            else if (cmd.type == command_type::geometry)
+            {
+                // Draw all the geometries using the same texture with a single call
+                size_t first_vertex = cmd.first_vertex;
+                size_t end_vertex   = cmd.first_vertex + cmd.vertex_count;
+                for (size_t j = i; j < end; j++)
+                {
+                    first_vertex = std::min(first_vertex, m_commands[j].first_vertex);
+                    end_vertex   = std::max(end_vertex, m_commands[j].first_vertex + m_commands[j].vertex_count);
+                }
+                m_merged_indices.clear();
+                for (size_t j = i; j < end; j++)
+                {
+                    const command& geometry_cmd = m_commands[j];
+                    int            base         = static_cast<int>(geometry_cmd.first_vertex - first_vertex);
+                    for (size_t k = 0; k < geometry_cmd.index_count; k++)
+                    {
+                        m_merged_indices.push_back(base + m_geometry_indices[geometry_cmd.first_index + k]);
+                    }
+                }
+                count_bind(cmd.source);
+                ret = (SDL_RenderGeometry(m_handle,
+                                          (cmd.source ? cmd.source->m_handle : nullptr),
+                                          &m_geometry_vertices[first_vertex],
+                                          static_cast<int>(end_vertex - first_vertex),
+                                          &m_merged_indices[0],
+                                          static_cast<int>(m_merged_indices.size())) == 0) &&
+                      ret;
+                m_stats->geometries++;
+            }
+            else
+            {
+                apply_blend_mode(cmd.blend_mode);
+                apply_draw_color(cmd.color);
+                if (cmd.type == command_type::clear)
+                {
+                    ret = (SDL_RenderClear(m_handle) == 0) && ret;
+                    m_stats->clears++;
+                    count_pixels(nullptr);
+                }
+                else
+                {
+                    m_merged_rects.clear();
+                    for (size_t j = i; j < end; j++)
+                    {
+                        m_merged_rects.push_back(m_commands[j].dst_rect);
+                    }
+                    int count = static_cast<int>(m_merged_rects.size());
+                    if (cmd.type == command_type::fill_rect)
+                    {
+                        ret = (SDL_RenderFillRects(m_handle, &m_merged_rects[0], count) == 0) && ret;
+                        m_stats->fills++;
+                        for (const auto& rect : m_merged_rects)
+                        {
+                            count_pixels(&rect);
+                        }
+                    }
+                    else
+                    {
+                        ret = (SDL_RenderDrawRects(m_handle, &m_merged_rects[0], count) == 0) && ret;
+                        m_stats->rects++;
+                    }
+                }
+            }
+
+            i = end;
+        }
+
+        // Restore the current state
+        apply_target(m_target);
+        apply_blend_mode(m_blend_mode);
+        apply_draw_color(m_draw_color);
+
+        m_commands.clear();
+        m_geometry_vertices.clear();
+        m_geometry_indices.clear();
+    }
+    m_left_targets.clear();
+
+    return ret;
+}
+
+/** @brief Prepare an operation which is not deferred */
+void sdl_renderer::prepare_immediate()
+{
+    if (m_is_deferred)
+    {
+        flush_commands();
+    }
+    flush_batch();
 }
 
 } // namespace sdl
@@ -22,11 +22,15 @@ along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
 #include <SDL2/SDL.h>
 #include <array>
 #include <memory>
-#include <stack>
+#include <unordered_map>
 #include <vector>
 
+#include "sdl_profiler.h"
+#include "sdl_render_stats.h"
+#include "sdl_sprite_batch.h"
 #include "sdl_surface.h"
 #include "sdl_texture.h"
+#include "sdl_texture_pool.h"
 
 namespace sdl
 {
@@ -94,11 +98,34 @@ class sdl_renderer
 
     /** @brief Set the blend mode */
     bool set_blend_mode(SDL_BlendMode blend_mode);
+    /** @brief Get the blend mode */
+    SDL_BlendMode get_blend_mode() const { return m_blend_mode; }
 
     /** @brief Set the draw color */
     bool set_draw_color(const SDL_Color& color);
     /** @brief Set the draw color */
     bool set_draw_color(Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+    /** @brief Get the draw color */
+    const SDL_Color& get_draw_color() const { return m_draw_color; }
+
+    /** @brief Set the clip rectangle of the current target (nullptr to disable clipping) */
+    bool set_clip_rect(const SDL_Rect* rect);
+    /** @brief Set the viewport of the current target (nullptr to use the whole target) */
+    bool set_viewport(const SDL_Rect* rect);
+
+    /** @brief Get the number of SDL state changes which have been skipped because they changed nothing */
+    Uint64 get_skipped_state_changes() const { return m_skipped_state_changes; }
+    /** @brief Get the rendering statistics of the last presented frame */
+    const render_stats& get_render_stats() const { return m_last_stats; }
+
+    /** @brief Get the profiler of the rendering operations */
+    sdl_profiler& get_profiler() { return m_profiler; }
+
+    /** @brief Get the pool recycling the textures of the renderer */
+    const texture_pool& get_texture_pool() const { return m_texture_pool; }
+
+    /** @brief Forget the state known by the renderer so that it is sent again to SDL (ex: after a device reset) */
+    void invalidate_state();
 
     /** @brief Draw a point */
     bool draw_point(const SDL_Point& p);
@@ -169,11 +196,212 @@ class sdl_renderer
               const SDL_Point*       center,
               const SDL_RendererFlip flip);
 
+    /**
+     * @brief Draw textured triangles
+     * @param texture Texture to use
+     * @param vertices Vertices of the triangles (texture coordinates are normalized)
+     * @param vertex_count Number of vertices
+     * @param indices Indices of the vertices of each triangle
+     * @param index_count Number of indices
+     * @return true if the triangles have been drawn, false otherwise
+     */
+    bool draw_geometry(texture& texture, const SDL_Vertex* vertices, int vertex_count, const int* indices, int index_count);
+
+    /**
+     * @brief Enable/disable the batching of the texture copies
+     *        When enabled, consecutive copies of the same texture are submitted with a single geometry call.
+     *        Any other drawing operation or target change draws the pending copies first to preserve drawing order.
+     * @param is_enabled true to enable the batching, false to disable it and draw the pending copies
+     */
+    void set_batching(bool is_enabled);
+    /** @brief Indicate if the batching of the texture copies is enabled */
+    bool is_batching() const { return m_is_batching; }
+
+    /**
+     * @brief Enable/disable the deferred rendering mode
+     *        In deferred mode, clears, copies, geometries, rectangles, draw color, blend mode and target changes are recorded
+     *        into a command queue instead of being sent to SDL. At present(), the commands are sorted by target
+     *        and layer, compatible adjacent commands are merged and the result is drawn.
+     *        A target is always drawn before being used as a texture. Inside a layer, the commands which do not overlap
+     *        the ones submitted before them are sorted by blend mode and texture, the overlapping ones keep their order.
+     *        Other drawing operations draw the recorded commands first and are executed immediately.
+     * @param is_enabled true to enable the deferred mode, false to disable it and draw the recorded commands
+     */
+    void set_deferred(bool is_enabled);
+    /** @brief Indicate if the deferred rendering mode is enabled */
+    bool is_deferred() const { return m_is_deferred; }
+
+    /** @brief Set the layer of the next drawing operations (deferred mode only, lower layers are drawn first) */
+    void set_layer(int layer) { m_layer = layer; }
+    /** @brief Get the layer of the next drawing operations */
+    int get_layer() const { return m_layer; }
+
   private:
+    /** @brief Type of a deferred command */
+    enum class command_type
+    {
+        clear,
+        fill_rect,
+        draw_rect,
+        copy,
+        geometry
+    };
+
+    /** @brief Drawing command recorded in deferred mode */
+    struct command
+    {
+        /** @brief Type of command */
+        command_type type;
+        /** @brief Target of the command (nullptr for the renderer) */
+        texture target;
+        /** @brief Drawing order of the target */
+        Uint64 target_rank;
+        /** @brief Layer */
+        int layer;
+        /** @brief Blend mode */
+        SDL_BlendMode blend_mode;
+        /** @brief Draw color */
+        SDL_Color color;
+        /** @brief Texture to copy */
+        texture source;
+        /** @brief Indicate if the source rectangle is valid */
+        bool has_src_rect;
+        /** @brief Source rectangle */
+        SDL_Rect src_rect;
+        /** @brief Indicate if the destination rectangle is valid */
+        bool has_dst_rect;
+        /** @brief Destination rectangle */
+        SDL_Rect dst_rect;
+        /** @brief Rotation angle in degrees */
+        double angle;
+        /** @brief Indicate if the center of rotation is valid */
+        bool has_center;
+        /** @brief Center of rotation */
+        SDL_Point center;
+        /** @brief Flip */
+        SDL_RendererFlip flip;
+        /** @brief Index of the first vertex of the geometry in the recorded vertices */
+        size_t first_vertex;
+        /** @brief Number of vertices of the geometry */
+        size_t vertex_count;
+        /** @brief Index of the first index of the geometry in the recorded indices */
+        size_t first_index;
+        /** @brief Number of indices of the geometry */
+        size_t index_count;
+        /** @brief Indicate if the area drawn by the command is known */
+        bool has_bounds;
+        /** @brief Bounding box of the area drawn by the command */
+        SDL_Rect bounds;
+    };
+
+    /** @brief Maximum number of commands of a layer reordered together to merge them */
+    static constexpr size_t MAX_REORDERED_COMMANDS = 256u;
+
+    /** @brief Drawing state sent to SDL */
+    struct render_state
+    {
+        /** @brief Indicate if the state is known */
+        bool is_valid;
+        /** @brief Indicate if the clip rectangle is known */
+        bool is_clip_valid;
+        /** @brief Indicate if the viewport is known */
+        bool is_viewport_valid;
+        /** @brief Target */
+        texture target;
+        /** @brief Draw color */
+        SDL_Color draw_color;
+        /** @brief Blend mode */
+        SDL_BlendMode blend_mode;
+        /** @brief Indicate if clipping is enabled */
+        bool is_clipping;
+        /** @brief Clip rectangle */
+        SDL_Rect clip_rect;
+        /** @brief Indicate if a viewport is set */
+        bool has_viewport;
+        /** @brief Viewport */
+        SDL_Rect viewport;
+    };
+
     /** @brief SDL handle */
     SDL_Renderer* m_handle;
     /** @brief Stack of target textures */
-    std::stack<texture> m_texture_stack;
+    std::vector<texture> m_texture_stack;
+    /** @brief Current target (nullptr for the renderer) */
+    texture m_target;
+    /** @brief Current draw color */
+    SDL_Color m_draw_color;
+    /** @brief Current blend mode */
+    SDL_BlendMode m_blend_mode;
+    /** @brief State which has been sent to SDL */
+    render_state m_sdl_state;
+    /** @brief Number of skipped state changes */
+    Uint64 m_skipped_state_changes;
+    /** @brief Rendering statistics of the current frame */
+    std::shared_ptr<render_stats> m_stats;
+    /** @brief Rendering statistics of the last presented frame */
+    render_stats m_last_stats;
+    /** @brief Last texture used for drawing */
+    texture m_bound_texture;
+    /** @brief Profiler of the rendering operations */
+    sdl_profiler m_profiler;
+    /** @brief Batch of texture copies */
+    sdl_sprite_batch m_sprite_batch;
+    /** @brief Indicate if the batching of the texture copies is enabled */
+    bool m_is_batching;
+    /** @brief Indicate if the deferred rendering mode is enabled */
+    bool m_is_deferred;
+    /** @brief Layer of the next drawing operations */
+    int m_layer;
+    /** @brief Recorded commands */
+    std::vector<command> m_commands;
+    /** @brief Sequence number at which each target has been left for the last time */
+    std::unordered_map<const sdl_texture*, Uint64> m_left_targets;
+    /** @brief Sequence number of the target changes */
+    Uint64 m_target_sequence;
+    /** @brief Rectangles of the merged commands */
+    std::vector<SDL_Rect> m_merged_rects;
+    /** @brief Vertices of the recorded geometries */
+    std::vector<SDL_Vertex> m_geometry_vertices;
+    /** @brief Indices of the recorded geometries */
+    std::vector<int> m_geometry_indices;
+    /** @brief Indices of the merged geometries */
+    std::vector<int> m_merged_indices;
+    /** @brief Pool recycling the textures of the renderer */
+    texture_pool m_texture_pool;
+
+    /** @brief Draw the pending texture copies */
+    void flush_batch();
+    /** @brief Add a texture copy to the batch */
+    bool batch_copy(texture&               texture,
+                    const SDL_Rect*        src_rect,
+                    const SDL_Rect&        dst_rect,
+                    const double           angle,
+                    const SDL_Point*       center,
+                    const SDL_RendererFlip flip);
+    /** @brief Wrap a newly created texture */
+    texture make_texture(SDL_Texture* handle, Uint64 uploaded_bytes);
+    /** @brief Count the use of a texture for drawing */
+    void count_bind(const texture& texture);
+    /** @brief Count the pixels written in a rectangle of the current target (nullptr for the whole target) */
+    void count_pixels(const SDL_Rect* rect);
+    /** @brief Change the current target */
+    bool change_target(const texture& target);
+    /** @brief Send the target to SDL if it has changed */
+    bool apply_target(const texture& target);
+    /** @brief Send the draw color to SDL if it has changed */
+    bool apply_draw_color(const SDL_Color& color);
+    /** @brief Send the blend mode to SDL if it has changed */
+    bool apply_blend_mode(SDL_BlendMode blend_mode);
+    /** @brief Initialize a deferred command with the current state */
+    command make_command(command_type type) const;
+    /** @brief Compute the bounding box of the area drawn by a deferred command */
+    bool get_bounds(const command& cmd, SDL_Rect& bounds) const;
+    /** @brief Order of the deferred commands putting the ones which can be merged next to each other */
+    static bool is_state_before(const command& a, const command& b);
+    /** @brief Sort, merge and draw the recorded commands */
+    bool flush_commands();
+    /** @brief Prepare an operation which is not deferred */
+    void prepare_immediate();
 
     /** 
      * @brief Constructor 
@@ -0,0 +1,146 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sdl_sprite_batch.h"
+
+#include <cmath>
+#include <utility>
+
+namespace sdl
+{
+
+/** @brief Pi constant */
+static constexpr double PI = 3.14159265358979323846;
+
+/** @brief Constructor */
+sdl_sprite_batch::sdl_sprite_batch(SDL_Renderer* renderer)
+    : m_renderer(renderer), m_texture(), m_texture_size{0, 0, 0, 0}, m_vertices(), m_indices()
+{
+}
+
+/** @brief Destructor */
+sdl_sprite_batch::~sdl_sprite_batch() { }
+
+/** @brief Add a textured quad to the batch */
+bool sdl_sprite_batch::add(texture&               texture,
+                           const SDL_Rect*        src_rect,
+                           const SDL_Rect&        dst_rect,
+                           const double           angle,
+                           const SDL_Point*       center,
+                           const SDL_RendererFlip flip)
+{
+    bool ret = true;
+
+    // Pending quads must be drawn before switching texture to preserve drawing order
+    if (texture != m_texture)
+    {
+        ret            = flush();
+        m_texture      = texture;
+        m_texture_size = m_texture->get_size();
+    }
+    if ((m_texture_size.w != 0) && (m_texture_size.h != 0))
+    {
+        // Texture coordinates
+        SDL_Rect src = (src_rect ? *src_rect : m_texture_size);
+        float    u0  = static_cast<float>(src.x) / static_cast<float>(m_texture_size.w);
+        float    v0  = static_cast<float>(src.y) / static_cast<float>(m_texture_size.h);
+        float    u1  = static_cast<float>(src.x + src.w) / static_cast<float>(m_texture_size.w);
+        float    v1  = static_cast<float>(src.y + src.h) / static_cast<float>(m_texture_size.h);
+        if ((flip & SDL_FLIP_HORIZONTAL) != 0)
+        {
+            std::swap(u0, u1);
+        }
+        if ((flip & SDL_FLIP_VERTICAL) != 0)
+        {
+            std::swap(v0, v1);
+        }
+        const SDL_FPoint tex_coords[] = {{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}};
+
+        // SDL_RenderGeometry() ignores the color and alpha modulation of the texture,
+        // they are applied through the color of the vertices as SDL_RenderCopy() does
+        SDL_Color color = {255, 255, 255, 255};
+        m_texture->get_color_mod(color.r, color.g, color.b);
+        m_texture->get_alpha_mod(color.a);
+
+        // Corners relative to the center of rotation
+        float            w         = static_cast<float>(dst_rect.w);
+        float            h         = static_cast<float>(dst_rect.h);
+        float            cx        = (center ? static_cast<float>(center->x) : (w / 2.f));
+        float            cy        = (center ? static_cast<float>(center->y) : (h / 2.f));
+        const SDL_FPoint corners[] = {{-cx, -cy}, {w - cx, -cy}, {w - cx, h - cy}, {-cx, h - cy}};
+
+        // Rotation is clockwise as for SDL_RenderCopyEx()
+        float cos_angle = 1.f;
+        float sin_angle = 0.f;
+        if (angle != 0.)
+        {
+            double radians = angle * PI / 180.;
+            cos_angle      = static_cast<float>(std::cos(radians));
+            sin_angle      = static_cast<float>(std::sin(radians));
+        }
+        float origin_x = static_cast<float>(dst_rect.x) + cx;
+        float origin_y = static_cast<float>(dst_rect.y) + cy;
+
+        // Add vertices
+        int first_vertex = static_cast<int>(m_vertices.size());
+        for (size_t i = 0; i < VERTICES_PER_QUAD; i++)
+        {
+            SDL_Vertex vertex;
+            vertex.position.x = origin_x + corners[i].x * cos_angle - corners[i].y * sin_angle;
+            vertex.position.y = origin_y + corners[i].x * sin_angle + corners[i].y * cos_angle;
+            vertex.color      = color;
+            vertex.tex_coord  = tex_coords[i];
+            m_vertices.push_back(vertex);
+        }
+
+        // 2 triangles per quad
+        m_indices.push_back(first_vertex);
+        m_indices.push_back(first_vertex + 1);
+        m_indices.push_back(first_vertex + 2);
+        m_indices.push_back(first_vertex);
+        m_indices.push_back(first_vertex + 2);
+        m_indices.push_back(first_vertex + 3);
+    }
+    else
+    {
+        ret = false;
+    }
+
+    return ret;
+}
+
+/** @brief Submit the pending quads to the renderer */
+bool sdl_sprite_batch::flush()
+{
+    bool ret = true;
+    if (!m_vertices.empty())
+    {
+        ret = (SDL_RenderGeometry(m_renderer,
+                                  m_texture->m_handle,
+                                  &m_vertices[0],
+                                  static_cast<int>(m_vertices.size()),
+                                  &m_indices[0],
+                                  static_cast<int>(m_indices.size())) == 0);
+        m_vertices.clear();
+        m_indices.clear();
+    }
+    m_texture.reset();
+    return ret;
+}
+
+} // namespace sdl
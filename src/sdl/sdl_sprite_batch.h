@@ -0,0 +1,99 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SDL_SPRITE_BATCH_H
+#define SDL_SPRITE_BATCH_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+#include "sdl_texture.h"
+
+namespace sdl
+{
+
+/** @brief Batch of textured quads submitted to the renderer with a single geometry call per texture */
+class sdl_sprite_batch
+{
+    // SDL renderer wrapper is friend to allow constructing a sprite batch
+    friend class sdl_renderer;
+
+  public:
+    /** @brief Destructor */
+    ~sdl_sprite_batch();
+
+    /** @brief Copy constructor => deleted */
+    sdl_sprite_batch(const sdl_sprite_batch& copy) = delete;
+    /** @brief Copy assignment => deleted */
+    sdl_sprite_batch& operator=(const sdl_sprite_batch& copy) = delete;
+
+    /**
+     * @brief Add a textured quad to the batch, the pending quads are flushed if the texture changes
+     * @param texture Texture to draw
+     * @param src_rect Area of the texture to draw (nullptr for the whole texture)
+     * @param dst_rect Destination area
+     * @param angle Rotation angle in degrees (clockwise)
+     * @param center Center of rotation relative to the destination area (nullptr for the center of the area)
+     * @param flip Flip to apply to the texture
+     * @return true if the quad has been added, false otherwise
+     */
+    bool add(texture&               texture,
+             const SDL_Rect*        src_rect,
+             const SDL_Rect&        dst_rect,
+             const double           angle,
+             const SDL_Point*       center,
+             const SDL_RendererFlip flip);
+
+    /**
+     * @brief Submit the pending quads to the renderer
+     * @return true if the quads have been submitted, false otherwise
+     */
+    bool flush();
+
+    /** @brief Get the texture of the pending quads */
+    const texture& get_texture() const { return m_texture; }
+    /** @brief Indicate if the batch contains pending quads */
+    bool is_empty() const { return m_vertices.empty(); }
+    /** @brief Get the number of pending quads */
+    size_t get_quad_count() const { return (m_vertices.size() / VERTICES_PER_QUAD); }
+
+  private:
+    /** @brief Number of vertices of a quad */
+    static constexpr size_t VERTICES_PER_QUAD = 4u;
+
+    /** @brief SDL renderer handle */
+    SDL_Renderer* m_renderer;
+    /** @brief Texture of the pending quads */
+    texture m_texture;
+    /** @brief Size of the texture of the pending quads */
+    SDL_Rect m_texture_size;
+    /** @brief Vertices of the pending quads */
+    std::vector<SDL_Vertex> m_vertices;
+    /** @brief Indices of the pending quads */
+    std::vector<int> m_indices;
+
+    /** 
+     * @brief Constructor 
+     * @param renderer SDL renderer handle
+     */
+    sdl_sprite_batch(SDL_Renderer* renderer);
+};
+
+} // namespace sdl
+
+#endif // SDL_SPRITE_BATCH_H
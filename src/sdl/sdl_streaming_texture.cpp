@@ -0,0 +1,134 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sdl_streaming_texture.h"
+
+namespace sdl
+{
+
+/** @brief Create a streaming texture */
+streaming_texture create_streaming_texture(const renderer& renderer, Uint32 format, int w, int h)
+{
+    return sdl_streaming_texture::create(renderer, format, w, h);
+}
+
+/** @brief Create a streaming texture */
+streaming_texture sdl_streaming_texture::create(const renderer& renderer, Uint32 format, int w, int h)
+{
+    streaming_texture instance;
+    if (renderer && !SDL_ISPIXELFORMAT_FOURCC(format))
+    {
+        texture contents = renderer->create_texture(format, SDL_TEXTUREACCESS_STREAMING, w, h);
+        if (contents)
+        {
+            auto p = new sdl_streaming_texture(contents, format);
+            instance.reset(p);
+        }
+    }
+    return instance;
+}
+
+/** @brief Constructor */
+sdl_streaming_texture::sdl_streaming_texture(const texture& texture, Uint32 format)
+    : m_texture(texture),
+      m_size(texture->get_size()),
+      m_bytes_per_pixel(SDL_BYTESPERPIXEL(format)),
+      m_pitch(m_size.w * m_bytes_per_pixel),
+      m_pixels(static_cast<size_t>(m_pitch) * static_cast<size_t>(m_size.h), 0u),
+      m_dirty_rects(),
+      m_uploaded_bytes(0u)
+{
+    // The texture contents are undefined until the first upload
+    mark_all_dirty();
+}
+
+/** @brief Mark an area of the CPU pixels as modified */
+void sdl_streaming_texture::mark_dirty(const SDL_Rect& rect)
+{
+    SDL_Rect dirty;
+    if (SDL_IntersectRect(&rect, &m_size, &dirty))
+    {
+        // Merge the area with the existing ones which overlap it or which are close enough
+        // so that uploading their union does not transfer much more bytes than uploading them separately
+        bool is_merged = true;
+        while (is_merged)
+        {
+            is_merged = false;
+            for (auto iter = m_dirty_rects.begin(); iter != m_dirty_rects.end(); ++iter)
+            {
+                SDL_Rect united;
+                SDL_UnionRect(&dirty, &*iter, &united);
+                Uint64 separate = get_area(dirty) + get_area(*iter);
+                if (SDL_HasIntersection(&dirty, &*iter) || (get_area(united) <= separate + separate / 4u))
+                {
+                    dirty = united;
+                    m_dirty_rects.erase(iter);
+                    is_merged = true;
+                    break;
+                }
+            }
+        }
+        m_dirty_rects.push_back(dirty);
+
+        // Limit the number of uploads
+        if (m_dirty_rects.size() > MAX_DIRTY_RECTS)
+        {
+            SDL_Rect bounds = m_dirty_rects[0];
+            for (const auto& r : m_dirty_rects)
+            {
+                SDL_UnionRect(&bounds, &r, &bounds);
+            }
+            m_dirty_rects.assign(1u, bounds);
+        }
+    }
+}
+
+/** @brief Upload the modified areas to the texture */
+bool sdl_streaming_texture::upload()
+{
+    bool ret         = true;
+    m_uploaded_bytes = 0u;
+    auto iter        = m_dirty_rects.begin();
+    while (iter != m_dirty_rects.end())
+    {
+        // Rows are read from the CPU buffer with its pitch, only the bytes of the area are transfered
+        const SDL_Rect& r      = *iter;
+        const Uint8*    pixels = &m_pixels[static_cast<size_t>(r.y) * static_cast<size_t>(m_pitch) +
+                                           static_cast<size_t>(r.x) * static_cast<size_t>(m_bytes_per_pixel)];
+        if (m_texture->update(&r, pixels, m_pitch))
+        {
+            m_uploaded_bytes += get_area(r) * static_cast<Uint64>(m_bytes_per_pixel);
+            iter = m_dirty_rects.erase(iter);
+        }
+        else
+        {
+            // Keep the area so that it is uploaded again on the next upload
+            ret = false;
+            ++iter;
+        }
+    }
+    return ret;
+}
+
+/** @brief Compute the area of a rectangle */
+Uint64 sdl_streaming_texture::get_area(const SDL_Rect& rect)
+{
+    return static_cast<Uint64>(rect.w) * static_cast<Uint64>(rect.h);
+}
+
+} // namespace sdl
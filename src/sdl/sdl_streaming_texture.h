@@ -0,0 +1,137 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SDL_STREAMING_TEXTURE_H
+#define SDL_STREAMING_TEXTURE_H
+
+#include <SDL2/SDL.h>
+#include <memory>
+#include <vector>
+
+#include "sdl_renderer.h"
+
+namespace sdl
+{
+
+// Forward declarations
+class sdl_streaming_texture;
+
+/** @brief SDL streaming texture */
+using streaming_texture = std::shared_ptr<sdl_streaming_texture>;
+
+/**
+ * @brief Create a streaming texture
+ * @param renderer Renderer which will own the texture
+ * @param format Pixel format of the texture
+ * @param w Width of the texture
+ * @param h Height of the texture
+ * @return SDL streaming texture object if the creation was successfull, nullptr otherwise
+ */
+streaming_texture create_streaming_texture(const renderer& renderer, Uint32 format, int w, int h);
+
+/** @brief Texture whose contents are generated by the CPU (ex: minimap, heatmap)
+ *         The pixels are written into a CPU buffer, the modified areas are marked as dirty
+ *         and only these areas are uploaded to the texture, once per frame */
+class sdl_streaming_texture
+{
+  public:
+    /**
+     * @brief Create a streaming texture
+     * @param renderer Renderer which will own the texture
+     * @param format Pixel format of the texture
+     * @param w Width of the texture
+     * @param h Height of the texture
+     * @return SDL streaming texture object if the creation was successfull, nullptr otherwise
+     */
+    static streaming_texture create(const renderer& renderer, Uint32 format, int w, int h);
+
+    /** @brief Destructor */
+    ~sdl_streaming_texture() = default;
+
+    /** @brief Copy constructor => deleted */
+    sdl_streaming_texture(const sdl_streaming_texture& copy) = delete;
+    /** @brief Copy assignment => deleted */
+    sdl_streaming_texture& operator=(const sdl_streaming_texture& copy) = delete;
+
+    /** @brief Get the texture to draw */
+    texture& get_texture() { return m_texture; }
+    /** @brief Get the size of the texture */
+    SDL_Rect get_size() const { return m_size; }
+
+    /** @brief Get the CPU pixels of the texture in its pixel format */
+    Uint8* get_pixels() { return &m_pixels[0]; }
+    /** @brief Get the number of bytes in a row of pixels */
+    int get_pitch() const { return m_pitch; }
+    /** @brief Get a row of CPU pixels */
+    Uint8* get_row(int y) { return &m_pixels[static_cast<size_t>(y) * static_cast<size_t>(m_pitch)]; }
+    /** @brief Get a row of CPU pixels as an array of pixel values (ex: Uint32 for 32bits formats) */
+    template <typename T>
+    T* get_row_as(int y)
+    {
+        return reinterpret_cast<T*>(get_row(y));
+    }
+
+    /** @brief Mark an area of the CPU pixels as modified */
+    void mark_dirty(const SDL_Rect& rect);
+    /** @brief Mark all the CPU pixels as modified */
+    void mark_all_dirty() { mark_dirty(m_size); }
+    /** @brief Get the modified areas waiting to be uploaded */
+    const std::vector<SDL_Rect>& get_dirty_rects() const { return m_dirty_rects; }
+
+    /**
+     * @brief Upload the modified areas to the texture, to be called once per frame before drawing the texture
+     * @return true if the modified areas have been uploaded, false otherwise (the areas which failed are uploaded again next time)
+     */
+    bool upload();
+
+    /** @brief Get the number of bytes transfered by the last upload */
+    Uint64 get_uploaded_bytes() const { return m_uploaded_bytes; }
+
+  private:
+    /** @brief Maximum number of separate dirty areas, above they are merged into their bounding box */
+    static constexpr size_t MAX_DIRTY_RECTS = 16u;
+
+    /** @brief Texture */
+    texture m_texture;
+    /** @brief Size of the texture */
+    SDL_Rect m_size;
+    /** @brief Number of bytes per pixel */
+    int m_bytes_per_pixel;
+    /** @brief Number of bytes in a row of CPU pixels */
+    int m_pitch;
+    /** @brief CPU pixels */
+    std::vector<Uint8> m_pixels;
+    /** @brief Modified areas, they never overlap */
+    std::vector<SDL_Rect> m_dirty_rects;
+    /** @brief Number of bytes transfered by the last upload */
+    Uint64 m_uploaded_bytes;
+
+    /** 
+     * @brief Constructor 
+     * @param texture Streaming texture
+     * @param format Pixel format of the texture
+     */
+    sdl_streaming_texture(const texture& texture, Uint32 format);
+
+    /** @brief Compute the area of a rectangle */
+    static Uint64 get_area(const SDL_Rect& rect);
+};
+
+} // namespace sdl
+
+#endif // SDL_STREAMING_TEXTURE_H
@@ -17,12 +17,49 @@ along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "sdl_surface.h"
+#include "sdl_pixel_kernels.h"
 
 #include <SDL2/SDL_image.h>
 
 namespace sdl
 {
 
+/** @brief Lock a surface for direct pixel access if needed */
+static bool lock_surface(SDL_Surface* handle)
+{
+    return (!SDL_MUSTLOCK(handle) || (SDL_LockSurface(handle) == 0));
+}
+
+/** @brief Unlock a surface locked for direct pixel access */
+static void unlock_surface(SDL_Surface* handle)
+{
+    if (SDL_MUSTLOCK(handle))
+    {
+        SDL_UnlockSurface(handle);
+    }
+}
+
+/** @brief Apply an in place pixel kernel on each row of a surface with a pixel format supported by the kernels */
+template <typename KernelFunc>
+static bool apply_on_rows(SDL_Surface* handle, KernelFunc kernel)
+{
+    bool         ret = false;
+    pixel_layout layout;
+    if (sdl_pixel_kernels::get_layout(handle->format->format, layout) && lock_surface(handle))
+    {
+        const sdl_pixel_kernels& kernels = sdl_pixel_kernels::get();
+        Uint8*                   row     = static_cast<Uint8*>(handle->pixels);
+        for (int y = 0; y < handle->h; y++)
+        {
+            kernel(kernels, reinterpret_cast<Uint32*>(row), static_cast<size_t>(handle->w), layout);
+            row += handle->pitch;
+        }
+        unlock_surface(handle);
+        ret = true;
+    }
+    return ret;
+}
+
 /** @brief Create a surface */
 surface create_surface(int width, int height, int depth, Uint32 r_mask, Uint32 g_mask, Uint32 b_mask, Uint32 a_mask)
 {
@@ -93,6 +130,120 @@ surface sdl_surface::duplicate() const
     return instance;
 }
 
+/** @brief Create a copy of the surface converted to another pixel format */
+surface sdl_surface::convert(Uint32 format) const
+{
+    surface      instance;
+    pixel_layout src_layout;
+    pixel_layout dst_layout;
+    if (sdl_pixel_kernels::get_layout(m_handle->format->format, src_layout) && sdl_pixel_kernels::get_layout(format, dst_layout) &&
+        !SDL_HasColorKey(m_handle))
+    {
+        // Conversions between 32 bits formats with alpha are a simple channel reordering
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, m_handle->w, m_handle->h, 32, format);
+        if (surface)
+        {
+            if (lock_surface(m_handle))
+            {
+                const sdl_pixel_kernels& kernels = sdl_pixel_kernels::get();
+                const Uint8*             src_row = static_cast<const Uint8*>(m_handle->pixels);
+                Uint8*                   dst_row = static_cast<Uint8*>(surface->pixels);
+                for (int y = 0; y < m_handle->h; y++)
+                {
+                    kernels.convert(reinterpret_cast<Uint32*>(dst_row),
+                                    reinterpret_cast<const Uint32*>(src_row),
+                                    static_cast<size_t>(m_handle->w),
+                                    src_layout,
+                                    dst_layout);
+                    src_row += m_handle->pitch;
+                    dst_row += surface->pitch;
+                }
+                unlock_surface(m_handle);
+
+                // Keep the modulation values, the blend mode and the clipping as SDL_ConvertSurfaceFormat() does
+                Uint8         r, g, b, a;
+                SDL_BlendMode blend_mode;
+                SDL_GetSurfaceColorMod(m_handle, &r, &g, &b);
+                SDL_GetSurfaceAlphaMod(m_handle, &a);
+                SDL_GetSurfaceBlendMode(m_handle, &blend_mode);
+                SDL_SetSurfaceColorMod(surface, r, g, b);
+                SDL_SetSurfaceAlphaMod(surface, a);
+                SDL_SetSurfaceBlendMode(surface, blend_mode);
+                SDL_SetClipRect(surface, &m_handle->clip_rect);
+
+                auto p = new sdl_surface(surface);
+                instance.reset(p);
+            }
+            else
+            {
+                SDL_FreeSurface(surface);
+            }
+        }
+    }
+    else
+    {
+        SDL_Surface* surface = SDL_ConvertSurfaceFormat(m_handle, format, 0);
+        if (surface)
+        {
+            auto p = new sdl_surface(surface);
+            instance.reset(p);
+        }
+    }
+    return instance;
+}
+
+/** @brief Create a copy of the surface resized with bilinear filtering */
+surface sdl_surface::resize_bilinear(int width, int height) const
+{
+    surface      instance;
+    pixel_layout layout;
+    if ((width > 0) && (height > 0) && (m_handle->w > 0) && (m_handle->h > 0))
+    {
+        if (sdl_pixel_kernels::get_layout(m_handle->format->format, layout))
+        {
+            SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, m_handle->format->format);
+            if (surface)
+            {
+                if (lock_surface(m_handle))
+                {
+                    sdl_pixel_kernels::get().resize_bilinear(static_cast<const Uint8*>(m_handle->pixels),
+                                                             m_handle->pitch,
+                                                             m_handle->w,
+                                                             m_handle->h,
+                                                             static_cast<Uint8*>(surface->pixels),
+                                                             surface->pitch,
+                                                             width,
+                                                             height);
+                    unlock_surface(m_handle);
+
+                    auto p = new sdl_surface(surface);
+                    instance.reset(p);
+                }
+                else
+                {
+                    SDL_FreeSurface(surface);
+                }
+            }
+        }
+        else
+        {
+            // Pixel formats not supported by the kernels are resized from a 32 bits copy
+            surface rgba = convert(SDL_PIXELFORMAT_RGBA32);
+            if (rgba)
+            {
+                instance = rgba->resize_bilinear(width, height);
+            }
+        }
+    }
+    return instance;
+}
+
+/** @brief Save the surface to a PNG image file */
+bool sdl_surface::save_png(const std::string& file) const
+{
+    return (IMG_SavePNG(m_handle, file.c_str()) == 0);
+}
+
 /** @brief Destructor */
 sdl_surface::~sdl_surface()
 {
@@ -217,4 +368,81 @@ bool sdl_surface::blit_scaled(const surface& src, const SDL_Rect* src_rect, SDL_
     return (SDL_BlitScaled(src->m_handle, src_rect, m_handle, dst_rect) == 0);
 }
 
+/** @brief Multiply the color channels by the alpha channel */
+bool sdl_surface::premultiply_alpha()
+{
+    return apply_on_rows(m_handle,
+                         [](const sdl_pixel_kernels& kernels, Uint32* pixels, size_t count, const pixel_layout& layout)
+                         { kernels.premultiply(pixels, count, layout.a_shift); });
+}
+
+/** @brief Divide the color channels by the alpha channel */
+bool sdl_surface::unpremultiply_alpha()
+{
+    return apply_on_rows(m_handle,
+                         [](const sdl_pixel_kernels& kernels, Uint32* pixels, size_t count, const pixel_layout& layout)
+                         { kernels.unpremultiply(pixels, count, layout.a_shift); });
+}
+
+/** @brief Multiply the color and alpha channels by a color */
+bool sdl_surface::modulate(const SDL_Color& color)
+{
+    Uint32 modulation = SDL_MapRGBA(m_handle->format, color.r, color.g, color.b, color.a);
+    return apply_on_rows(m_handle,
+                         [modulation](const sdl_pixel_kernels& kernels, Uint32* pixels, size_t count, const pixel_layout&)
+                         { kernels.modulate(pixels, count, modulation); });
+}
+
+/** @brief Blend the non premultiplied pixels of a surface with the same pixel format over the pixels of the surface */
+bool sdl_surface::blend(const surface& src, const SDL_Rect* src_rect, const SDL_Point& dst_pos)
+{
+    bool         ret    = false;
+    SDL_Surface* source = src->m_handle;
+    pixel_layout layout;
+    if ((source->format->format == m_handle->format->format) && sdl_pixel_kernels::get_layout(m_handle->format->format, layout))
+    {
+        // Clip the blended area to the source surface and to the clipping rectangle of the destination surface
+        SDL_Rect src_bounds = {0, 0, source->w, source->h};
+        SDL_Rect src_area   = src_bounds;
+        SDL_Rect dst_area   = {0, 0, 0, 0};
+        if (!src_rect || SDL_IntersectRect(src_rect, &src_bounds, &src_area))
+        {
+            SDL_Rect dst_rect = {dst_pos.x, dst_pos.y, src_area.w, src_area.h};
+            if (SDL_IntersectRect(&dst_rect, &m_handle->clip_rect, &dst_area))
+            {
+                src_area.x += dst_area.x - dst_rect.x;
+                src_area.y += dst_area.y - dst_rect.y;
+            }
+        }
+
+        ret = true;
+        if ((dst_area.w > 0) && (dst_area.h > 0))
+        {
+            ret = false;
+            if (lock_surface(source))
+            {
+                if (lock_surface(m_handle))
+                {
+                    const sdl_pixel_kernels& kernels = sdl_pixel_kernels::get();
+                    const Uint8*             src_row = static_cast<const Uint8*>(source->pixels) + src_area.y * source->pitch;
+                    Uint8*                   dst_row = static_cast<Uint8*>(m_handle->pixels) + dst_area.y * m_handle->pitch;
+                    for (int y = 0; y < dst_area.h; y++)
+                    {
+                        kernels.blend(reinterpret_cast<Uint32*>(dst_row) + dst_area.x,
+                                      reinterpret_cast<const Uint32*>(src_row) + src_area.x,
+                                      static_cast<size_t>(dst_area.w),
+                                      layout.a_shift);
+                        src_row += source->pitch;
+                        dst_row += m_handle->pitch;
+                    }
+                    unlock_surface(m_handle);
+                    ret = true;
+                }
+                unlock_surface(source);
+            }
+        }
+    }
+    return ret;
+}
+
 } // namespace sdl
@@ -33,6 +33,7 @@ class sdl_renderer;
 class sdl_surface;
 class sdl_window;
 class sdl_font;
+class sdl_texture_atlas;
 
 /** @brief SDL surface */
 using surface = std::shared_ptr<sdl_surface>;
@@ -76,6 +77,8 @@ class sdl_surface
     friend class sdl_renderer;
     // SDL font wrapper is friend to allow constructing a surface from the font
     friend class sdl_font;
+    // SDL texture atlas is friend to allow uploading the pixels of the surface
+    friend class sdl_texture_atlas;
 
   public:
     /**
@@ -114,6 +117,28 @@ class sdl_surface
      */
     surface duplicate() const;
 
+    /** 
+     * @brief Create a copy of the surface converted to another pixel format
+     * @param format Pixel format of the new surface
+     * @return New surface with the requested pixel format if the conversion was successfull, nullptr otherwise
+     */
+    surface convert(Uint32 format) const;
+
+    /** 
+     * @brief Create a copy of the surface resized with bilinear filtering
+     * @param width Width in pixels of the new surface
+     * @param height Height in pixels of the new surface
+     * @return New surface with the requested size if the resize was successfull, nullptr otherwise (ex: empty surface)
+     */
+    surface resize_bilinear(int width, int height) const;
+
+    /** 
+     * @brief Save the surface to a PNG image file
+     * @param file Path to the image file
+     * @return true if the surface has been saved, false otherwise
+     */
+    bool save_png(const std::string& file) const;
+
     /** @brief Destructor */
     ~sdl_surface();
 
@@ -174,8 +199,21 @@ class sdl_surface
     /** @brief Performs a blit from the source surface to the destination surface with scaling */
     bool blit_scaled(const surface& src, const SDL_Rect* src_rect, SDL_Rect* dst_rect);
 
+    /** @brief Multiply the color channels by the alpha channel (32 bits pixel formats with 8 bits alpha only) */
+    bool premultiply_alpha();
+    /** @brief Divide the color channels by the alpha channel (32 bits pixel formats with 8 bits alpha only) */
+    bool unpremultiply_alpha();
+    /** @brief Multiply the color and alpha channels by a color (32 bits pixel formats with 8 bits alpha only) */
+    bool modulate(const SDL_Color& color);
+    /** @brief Blend the non premultiplied pixels of a surface with the same pixel format over the pixels of the surface */
+    bool blend(const surface& src, const SDL_Rect* src_rect, const SDL_Point& dst_pos);
+
     /** @brief Get the pixel format of the surface */
     const SDL_PixelFormat* get_pixel_format() const { return m_handle->format; }
+    /** @brief Get the pixels of the surface (the surface must not be RLE encoded) */
+    const void* get_pixels() const { return m_handle->pixels; }
+    /** @brief Get the number of bytes in a row of pixels */
+    int get_pitch() const { return m_handle->pitch; }
 
   private:
     /** @brief SDL handle */
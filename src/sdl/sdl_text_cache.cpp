@@ -0,0 +1,214 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sdl_text_cache.h"
+
+#include <functional>
+
+namespace sdl
+{
+
+/** @brief Create a text cache */
+text_cache create_text_cache(Uint64 max_bytes)
+{
+    return sdl_text_cache::create(max_bytes);
+}
+
+/** @brief Create a text cache */
+text_cache sdl_text_cache::create(Uint64 max_bytes)
+{
+    text_cache instance;
+    auto       p = new sdl_text_cache(max_bytes);
+    instance.reset(p);
+    return instance;
+}
+
+/** @brief Constructor */
+sdl_text_cache::sdl_text_cache(Uint64 max_bytes)
+    : m_entries(), m_index(), m_max_bytes(max_bytes), m_bytes(0u), m_hits(0u), m_misses(0u)
+{
+}
+
+/** @brief Get the texture of a text, render it if it is not in the cache */
+texture sdl_text_cache::render(const renderer&    renderer,
+                               const font&        font,
+                               const std::string& text,
+                               const SDL_Color&   fg_color,
+                               render_mode        mode,
+                               Uint32             wrap_length)
+{
+    texture contents;
+
+    if (renderer && font)
+    {
+        if (mode != render_mode::blended)
+        {
+            wrap_length = 0;
+        }
+        key id = {renderer.get(),
+                  font.get(),
+                  text,
+                  (static_cast<Uint32>(fg_color.r) << 24u) | (static_cast<Uint32>(fg_color.g) << 16u) |
+                      (static_cast<Uint32>(fg_color.b) << 8u) | static_cast<Uint32>(fg_color.a),
+                  mode,
+                  wrap_length};
+
+        auto iter = m_index.find(id);
+        if (iter != m_index.end())
+        {
+            // Move the text at the front of the LRU list
+            m_entries.splice(m_entries.begin(), m_entries, iter->second);
+            contents = iter->second->contents;
+            m_hits++;
+        }
+        else
+        {
+            // Render the text
+            surface text_surface;
+            if (mode == render_mode::solid)
+            {
+                text_surface = font->render_solid(text, fg_color);
+            }
+            else if (wrap_length != 0)
+            {
+                text_surface = font->render_blended_wrapped(text, fg_color, wrap_length);
+            }
+            else
+            {
+                text_surface = font->render_blended(text, fg_color);
+            }
+            if (text_surface)
+            {
+                contents = renderer->create_texture(text_surface);
+            }
+            m_misses++;
+
+            // Store the texture if it fits in the cache
+            if (contents)
+            {
+                Uint64 bytes = contents->get_memory_size();
+                if (bytes <= m_max_bytes)
+                {
+                    shrink(m_max_bytes - bytes);
+                    m_entries.push_front({id, contents, bytes});
+                    m_index.emplace(std::move(id), m_entries.begin());
+                    m_bytes += bytes;
+                }
+            }
+        }
+    }
+
+    return contents;
+}
+
+/** @brief Remove all the texts rendered with a font */
+void sdl_text_cache::remove(const sdl_font* font)
+{
+    auto iter = m_entries.begin();
+    while (iter != m_entries.end())
+    {
+        if (iter->id.font == font)
+        {
+            m_bytes -= iter->bytes;
+            m_index.erase(iter->id);
+            iter = m_entries.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
+/** @brief Remove all the texts rendered for a renderer */
+void sdl_text_cache::remove(const sdl_renderer* renderer)
+{
+    auto iter = m_entries.begin();
+    while (iter != m_entries.end())
+    {
+        if (iter->id.renderer == renderer)
+        {
+            m_bytes -= iter->bytes;
+            m_index.erase(iter->id);
+            iter = m_entries.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
+/** @brief Remove all the texts */
+void sdl_text_cache::clear()
+{
+    m_index.clear();
+    m_entries.clear();
+    m_bytes = 0u;
+}
+
+/** @brief Set the maximum number of bytes of the cached textures, the least recently used ones are removed above */
+void sdl_text_cache::set_max_bytes(Uint64 max_bytes)
+{
+    m_max_bytes = max_bytes;
+    shrink(m_max_bytes);
+}
+
+/** @brief Get the ratio of the requests found in the cache */
+float sdl_text_cache::get_hit_rate() const
+{
+    float  rate     = 0.f;
+    Uint64 requests = m_hits + m_misses;
+    if (requests != 0u)
+    {
+        rate = static_cast<float>(m_hits) / static_cast<float>(requests);
+    }
+    return rate;
+}
+
+/** @brief Remove the least recently used texts until the cache is below a number of bytes */
+void sdl_text_cache::shrink(Uint64 max_bytes)
+{
+    while (!m_entries.empty() && (m_bytes > max_bytes))
+    {
+        const entry& oldest = m_entries.back();
+        m_bytes -= oldest.bytes;
+        m_index.erase(oldest.id);
+        m_entries.pop_back();
+    }
+}
+
+/** @brief Comparison operator */
+bool sdl_text_cache::key::operator==(const key& other) const
+{
+    return (renderer == other.renderer) && (font == other.font) && (color == other.color) && (mode == other.mode) &&
+           (wrap_length == other.wrap_length) && (text == other.text);
+}
+
+/** @brief Compute the hash of a key */
+size_t sdl_text_cache::key_hash::operator()(const key& k) const
+{
+    size_t hash = std::hash<std::string>()(k.text);
+    hash ^= std::hash<const void*>()(k.font) + 0x9E3779B97F4A7C15ull + (hash << 6u) + (hash >> 2u);
+    hash ^= std::hash<const void*>()(k.renderer) + 0x9E3779B97F4A7C15ull + (hash << 6u) + (hash >> 2u);
+    hash ^= std::hash<Uint64>()((static_cast<Uint64>(k.color) << 32u) | (static_cast<Uint64>(k.mode) << 31u) | k.wrap_length) +
+            0x9E3779B97F4A7C15ull + (hash << 6u) + (hash >> 2u);
+    return hash;
+}
+
+} // namespace sdl
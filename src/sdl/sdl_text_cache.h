@@ -0,0 +1,175 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SDL_TEXT_CACHE_H
+#define SDL_TEXT_CACHE_H
+
+#include <SDL2/SDL.h>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "sdl_font.h"
+#include "sdl_renderer.h"
+
+namespace sdl
+{
+
+// Forward declarations
+class sdl_text_cache;
+
+/** @brief SDL text cache */
+using text_cache = std::shared_ptr<sdl_text_cache>;
+
+/**
+ * @brief Create a text cache
+ * @param max_bytes Maximum number of bytes of the cached textures
+ * @return SDL text cache object if the creation was successfull, nullptr otherwise
+ */
+text_cache create_text_cache(Uint64 max_bytes);
+
+/** @brief Bounded LRU cache of the textures of rendered texts */
+class sdl_text_cache
+{
+  public:
+    /** @brief Text rendering mode */
+    enum class render_mode
+    {
+        /** @brief Fast rendering without antialiasing */
+        solid,
+        /** @brief Antialiased rendering with an alpha channel */
+        blended
+    };
+
+    /**
+     * @brief Create a text cache
+     * @param max_bytes Maximum number of bytes of the cached textures
+     * @return SDL text cache object if the creation was successfull, nullptr otherwise
+     */
+    static text_cache create(Uint64 max_bytes);
+
+    /** @brief Destructor */
+    ~sdl_text_cache() = default;
+
+    /** @brief Copy constructor => deleted */
+    sdl_text_cache(const sdl_text_cache& copy) = delete;
+    /** @brief Copy assignment => deleted */
+    sdl_text_cache& operator=(const sdl_text_cache& copy) = delete;
+
+    /**
+     * @brief Get the texture of a text, render it if it is not in the cache
+     * @param renderer Renderer which will draw the texture
+     * @param font Font to use
+     * @param text Text to write
+     * @param fg_color Text color
+     * @param mode Rendering mode
+     * @param wrap_length Length in pixel before wrapping (blended mode only, 0 to disable wrapping)
+     * @return SDL texture object if the rendering was successfull, nullptr otherwise
+     */
+    texture render(const renderer&    renderer,
+                   const font&        font,
+                   const std::string& text,
+                   const SDL_Color&   fg_color,
+                   render_mode        mode        = render_mode::blended,
+                   Uint32             wrap_length = 0);
+
+    /** @brief Remove all the texts rendered with a font */
+    void remove(const sdl_font* font);
+    /** @brief Remove all the texts rendered for a renderer */
+    void remove(const sdl_renderer* renderer);
+    /** @brief Remove all the texts */
+    void clear();
+
+    /** @brief Set the maximum number of bytes of the cached textures, the least recently used ones are removed above */
+    void set_max_bytes(Uint64 max_bytes);
+    /** @brief Get the maximum number of bytes of the cached textures */
+    Uint64 get_max_bytes() const { return m_max_bytes; }
+    /** @brief Get the number of bytes of the cached textures */
+    Uint64 get_bytes() const { return m_bytes; }
+    /** @brief Get the number of cached textures */
+    size_t get_count() const { return m_entries.size(); }
+    /** @brief Get the number of requests found in the cache */
+    Uint64 get_hit_count() const { return m_hits; }
+    /** @brief Get the number of requests which have been rendered */
+    Uint64 get_miss_count() const { return m_misses; }
+    /** @brief Get the ratio of the requests found in the cache */
+    float get_hit_rate() const;
+
+  private:
+    /** @brief Key of a cached text */
+    struct key
+    {
+        /** @brief Renderer which owns the texture */
+        const sdl_renderer* renderer;
+        /** @brief Font */
+        const sdl_font* font;
+        /** @brief Text */
+        std::string text;
+        /** @brief Text color */
+        Uint32 color;
+        /** @brief Rendering mode */
+        render_mode mode;
+        /** @brief Wrap length */
+        Uint32 wrap_length;
+
+        /** @brief Comparison operator */
+        bool operator==(const key& other) const;
+    };
+
+    /** @brief Hash of a key */
+    struct key_hash
+    {
+        /** @brief Compute the hash of a key */
+        size_t operator()(const key& k) const;
+    };
+
+    /** @brief Cached text */
+    struct entry
+    {
+        /** @brief Key */
+        key id;
+        /** @brief Texture */
+        texture contents;
+        /** @brief Size of the texture in bytes */
+        Uint64 bytes;
+    };
+
+    /** @brief Cached texts, from the most to the least recently used */
+    std::list<entry> m_entries;
+    /** @brief Cached texts indexed by key */
+    std::unordered_map<key, std::list<entry>::iterator, key_hash> m_index;
+    /** @brief Maximum number of bytes of the cached textures */
+    Uint64 m_max_bytes;
+    /** @brief Number of bytes of the cached textures */
+    Uint64 m_bytes;
+    /** @brief Number of requests found in the cache */
+    Uint64 m_hits;
+    /** @brief Number of requests which have been rendered */
+    Uint64 m_misses;
+
+    /** @brief Constructor */
+    sdl_text_cache(Uint64 max_bytes);
+
+    /** @brief Remove the least recently used texts until the cache is below a number of bytes */
+    void shrink(Uint64 max_bytes);
+};
+
+} // namespace sdl
+
+#endif // SDL_TEXT_CACHE_H
@@ -24,11 +24,18 @@ namespace sdl
 /** @brief Destructor */
 sdl_texture::~sdl_texture()
 {
+    auto stats = m_stats.lock();
+    if (stats)
+    {
+        stats->textures_destroyed++;
+        stats->texture_memory -= get_memory_size();
+    }
+
     SDL_DestroyTexture(m_handle);
 }
 
 /** @brief Constructor */
-sdl_texture::sdl_texture(SDL_Texture* handle) : m_handle(handle) { }
+sdl_texture::sdl_texture(SDL_Texture* handle, const std::weak_ptr<render_stats>& stats) : m_handle(handle), m_stats(stats) { }
 
 /** @brief Get the format of the texture */
 Uint32 sdl_texture::get_format() const
@@ -54,10 +61,105 @@ SDL_Rect sdl_texture::get_size() const
     return size;
 }
 
+/** @brief Get the estimated memory used by the texture in bytes */
+Uint64 sdl_texture::get_memory_size() const
+{
+    Uint32 format = 0;
+    int    w      = 0;
+    int    h      = 0;
+    SDL_QueryTexture(m_handle, &format, nullptr, &w, &h);
+    return (static_cast<Uint64>(w) * static_cast<Uint64>(h) * SDL_BYTESPERPIXEL(format));
+}
+
 /** @brief Set the blend mode */
 bool sdl_texture::set_blend_mode(SDL_BlendMode blend_mode)
 {
     return (SDL_SetTextureBlendMode(m_handle, blend_mode) == 0);
 }
 
+/** @brief Set the filtering used when the texture is scaled */
+bool sdl_texture::set_scale_mode(SDL_ScaleMode scale_mode)
+{
+    return (SDL_SetTextureScaleMode(m_handle, scale_mode) == 0);
+}
+
+/** @brief Get the filtering used when the texture is scaled */
+bool sdl_texture::get_scale_mode(SDL_ScaleMode& scale_mode) const
+{
+    return (SDL_GetTextureScaleMode(m_handle, &scale_mode) == 0);
+}
+
+/** @brief Set an additional color value multiplied into the drawing operations */
+bool sdl_texture::set_color_mod(Uint8 r, Uint8 g, Uint8 b)
+{
+    return (SDL_SetTextureColorMod(m_handle, r, g, b) == 0);
+}
+
+/** @brief Get the additional color value multiplied into the drawing operations */
+bool sdl_texture::get_color_mod(Uint8& r, Uint8& g, Uint8& b) const
+{
+    return (SDL_GetTextureColorMod(m_handle, &r, &g, &b) == 0);
+}
+
+/** @brief Set an additional alpha value multiplied into the drawing operations */
+bool sdl_texture::set_alpha_mod(Uint8 alpha)
+{
+    return (SDL_SetTextureAlphaMod(m_handle, alpha) == 0);
+}
+
+/** @brief Get the additional alpha value multiplied into the drawing operations */
+bool sdl_texture::get_alpha_mod(Uint8& alpha) const
+{
+    return (SDL_GetTextureAlphaMod(m_handle, &alpha) == 0);
+}
+
+/** @brief Update a rectangle of the texture with new pixel data */
+bool sdl_texture::update(const SDL_Rect* rect, const void* pixels, int pitch)
+{
+    bool ret = (SDL_UpdateTexture(m_handle, rect, pixels, pitch) == 0);
+    if (ret)
+    {
+        auto stats = m_stats.lock();
+        if (stats)
+        {
+            // Only the bytes of the updated area are transfered, not the padding of the rows
+            SDL_Rect area = (rect ? *rect : get_size());
+            stats->bytes_uploaded +=
+                static_cast<Uint64>(area.w) * static_cast<Uint64>(area.h) * SDL_BYTESPERPIXEL(get_format());
+        }
+    }
+    return ret;
+}
+
+/** @brief Constructor, lock an area of the texture */
+texture_lock::texture_lock(const texture& texture, const SDL_Rect* rect)
+    : m_texture(texture), m_rect{0, 0, 0, 0}, m_pixels(nullptr), m_pitch(0)
+{
+    if (m_texture)
+    {
+        void* pixels = nullptr;
+        if (SDL_LockTexture(m_texture->m_handle, rect, &pixels, &m_pitch) == 0)
+        {
+            m_rect   = (rect ? *rect : m_texture->get_size());
+            m_pixels = static_cast<Uint8*>(pixels);
+        }
+    }
+}
+
+/** @brief Destructor, unlock the texture */
+texture_lock::~texture_lock()
+{
+    if (m_pixels)
+    {
+        SDL_UnlockTexture(m_texture->m_handle);
+
+        auto stats = m_texture->m_stats.lock();
+        if (stats)
+        {
+            stats->bytes_uploaded +=
+                static_cast<Uint64>(m_rect.w) * static_cast<Uint64>(m_rect.h) * SDL_BYTESPERPIXEL(m_texture->get_format());
+        }
+    }
+}
+
 } // namespace sdl
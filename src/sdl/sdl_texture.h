@@ -22,21 +22,38 @@ along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
 #include <SDL2/SDL.h>
 #include <memory>
 
+#include "sdl_render_stats.h"
+
 namespace sdl
 {
 
 // Forward declarations
 class sdl_renderer;
+class sdl_sprite_batch;
 class sdl_texture;
+class texture_lock;
 
 /** @brief SDL texture */
 using texture = std::shared_ptr<sdl_texture>;
 
+/** @brief Rectangular region of a texture */
+struct texture_region
+{
+    /** @brief Texture containing the region */
+    texture source;
+    /** @brief Position and size of the region in the texture */
+    SDL_Rect rect;
+};
+
 /** @brief Wrapper for SDL texture */
 class sdl_texture
 {
     // SDL renderer wrapper is friend to allow constructing a texture
     friend class sdl_renderer;
+    // SDL sprite batch is friend to allow drawing the texture
+    friend class sdl_sprite_batch;
+    // Texture lock is friend to allow accessing the pixels of the texture
+    friend class texture_lock;
 
   public:
     /** @brief Destructor */
@@ -48,19 +65,94 @@ class sdl_texture
     int get_access() const;
     /** @brief Get the size of the texture */
     SDL_Rect get_size() const;
+    /** @brief Get the estimated memory used by the texture in bytes */
+    Uint64 get_memory_size() const;
 
     /** @brief Set the blend mode */
     bool set_blend_mode(SDL_BlendMode blend_mode);
+    /** @brief Set the filtering used when the texture is scaled */
+    bool set_scale_mode(SDL_ScaleMode scale_mode);
+    /** @brief Get the filtering used when the texture is scaled */
+    bool get_scale_mode(SDL_ScaleMode& scale_mode) const;
+
+    /** @brief Set an additional color value multiplied into the drawing operations */
+    bool set_color_mod(Uint8 r, Uint8 g, Uint8 b);
+    /** @brief Get the additional color value multiplied into the drawing operations */
+    bool get_color_mod(Uint8& r, Uint8& g, Uint8& b) const;
+
+    /** @brief Set an additional alpha value multiplied into the drawing operations */
+    bool set_alpha_mod(Uint8 alpha);
+    /** @brief Get the additional alpha value multiplied into the drawing operations */
+    bool get_alpha_mod(Uint8& alpha) const;
+
+    /**
+     * @brief Update a rectangle of the texture with new pixel data
+     * @param rect Rectangle to update (nullptr to update the whole texture)
+     * @param pixels Pixel data in the format of the texture
+     * @param pitch Number of bytes in a row of pixel data
+     * @return true if the update was successfull, false otherwise
+     */
+    bool update(const SDL_Rect* rect, const void* pixels, int pitch);
 
   private:
     /** @brief SDL handle */
     SDL_Texture* m_handle;
+    /** @brief Rendering statistics of the renderer which created the texture */
+    std::weak_ptr<render_stats> m_stats;
 
     /** 
      * @brief Constructor 
      * @param handle SDL handle
+     * @param stats Rendering statistics of the renderer which created the texture
+     */
+    sdl_texture(SDL_Texture* handle, const std::weak_ptr<render_stats>& stats);
+};
+
+/** @brief Scoped write-only access to the pixels of an area of a streaming texture,
+ *         the texture is updated with the written pixels when the lock is destroyed */
+class texture_lock
+{
+  public:
+    /**
+     * @brief Constructor, lock an area of the texture
+     * @param texture Texture to lock, it must have been created with SDL_TEXTUREACCESS_STREAMING
+     * @param rect Area to lock (nullptr to lock the whole texture)
      */
-    sdl_texture(SDL_Texture* handle);
+    texture_lock(const texture& texture, const SDL_Rect* rect = nullptr);
+    /** @brief Destructor, unlock the texture */
+    ~texture_lock();
+
+    /** @brief Copy constructor => deleted */
+    texture_lock(const texture_lock& copy) = delete;
+    /** @brief Copy assignment => deleted */
+    texture_lock& operator=(const texture_lock& copy) = delete;
+
+    /** @brief Indicate if the texture has been locked */
+    bool is_locked() const { return (m_pixels != nullptr); }
+    /** @brief Get the locked area of the texture */
+    const SDL_Rect& get_rect() const { return m_rect; }
+    /** @brief Get the pixels of the locked area, their previous contents are undefined */
+    Uint8* get_pixels() const { return m_pixels; }
+    /** @brief Get the number of bytes in a row of pixels */
+    int get_pitch() const { return m_pitch; }
+    /** @brief Get a row of pixels of the locked area */
+    Uint8* get_row(int y) const { return (m_pixels + y * m_pitch); }
+    /** @brief Get a row of pixels of the locked area as an array of pixel values (ex: Uint32 for 32bits formats) */
+    template <typename T>
+    T* get_row_as(int y) const
+    {
+        return reinterpret_cast<T*>(get_row(y));
+    }
+
+  private:
+    /** @brief Locked texture */
+    texture m_texture;
+    /** @brief Locked area */
+    SDL_Rect m_rect;
+    /** @brief Pixels of the locked area */
+    Uint8* m_pixels;
+    /** @brief Number of bytes in a row of pixels */
+    int m_pitch;
 };
 
 } // namespace sdl
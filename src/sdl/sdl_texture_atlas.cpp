@@ -0,0 +1,286 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sdl_texture_atlas.h"
+
+#include <climits>
+
+namespace sdl
+{
+
+/** @brief Create a texture atlas */
+texture_atlas create_texture_atlas(const renderer& renderer, int page_width, int page_height)
+{
+    return sdl_texture_atlas::create(renderer, page_width, page_height);
+}
+
+/** @brief Create a texture atlas */
+texture_atlas sdl_texture_atlas::create(const renderer& renderer, int page_width, int page_height)
+{
+    texture_atlas instance;
+    if (renderer && (page_width > 0) && (page_height > 0))
+    {
+        // Limit page size to the maximum texture size supported by the renderer
+        SDL_RendererInfo info;
+        if (renderer->get_info(info))
+        {
+            if ((info.max_texture_width != 0) && (page_width > info.max_texture_width))
+            {
+                page_width = info.max_texture_width;
+            }
+            if ((info.max_texture_height != 0) && (page_height > info.max_texture_height))
+            {
+                page_height = info.max_texture_height;
+            }
+        }
+
+        auto p = new sdl_texture_atlas(renderer, page_width, page_height);
+        instance.reset(p);
+    }
+    return instance;
+}
+
+/** @brief Destructor */
+sdl_texture_atlas::~sdl_texture_atlas() { }
+
+/** @brief Constructor */
+sdl_texture_atlas::sdl_texture_atlas(const renderer& renderer, int page_width, int page_height)
+    : m_renderer(renderer), m_page_width(page_width), m_page_height(page_height), m_format(SDL_PIXELFORMAT_ARGB8888), m_pages()
+{
+}
+
+/** @brief Add an image to the atlas */
+bool sdl_texture_atlas::add(const surface& image, texture_region& region)
+{
+    bool ret = false;
+    if (image)
+    {
+        // Convert the image to the format of the pages
+        surface source = image;
+        if (image->m_handle->format->format != m_format)
+        {
+            source = image->convert(m_format);
+        }
+        if (source)
+        {
+            // Upload pixels
+            SDL_Surface* handle = source->m_handle;
+            if (SDL_MUSTLOCK(handle))
+            {
+                SDL_LockSurface(handle);
+            }
+            ret = add(handle->pixels, handle->pitch, handle->w, handle->h, region);
+            if (SDL_MUSTLOCK(handle))
+            {
+                SDL_UnlockSurface(handle);
+            }
+        }
+    }
+    return ret;
+}
+
+/** @brief Add raw pixels to the atlas */
+bool sdl_texture_atlas::add(const void* pixels, int pitch, int w, int h, texture_region& region)
+{
+    bool ret = false;
+    if (pixels && (w > 0) && (h > 0))
+    {
+        // Look for a free area
+        if (allocate(w, h, region))
+        {
+            ret = region.source->update(&region.rect, pixels, pitch);
+        }
+    }
+    return ret;
+}
+
+/** @brief Create a new empty page */
+sdl_texture_atlas::page* sdl_texture_atlas::create_page(int w, int h)
+{
+    page* new_page = nullptr;
+
+    texture contents = m_renderer->create_texture(m_format, SDL_TEXTUREACCESS_STATIC, w, h);
+    if (contents)
+    {
+        // Start with a fully transparent page so that padding areas do not bleed
+        std::vector<Uint32> pixels(static_cast<size_t>(w) * static_cast<size_t>(h), 0u);
+        contents->update(nullptr, &pixels[0], w * static_cast<int>(sizeof(Uint32)));
+        contents->set_blend_mode(SDL_BLENDMODE_BLEND);
+
+        m_pages.push_back({contents, w, h, {{0, 0, w}}});
+        new_page = &m_pages.back();
+    }
+
+    return new_page;
+}
+
+/** @brief Allocate an area in the pages of the atlas */
+bool sdl_texture_atlas::allocate(int w, int h, texture_region& region)
+{
+    bool ret = false;
+
+    int padded_w = w + PADDING;
+    int padded_h = h + PADDING;
+    if ((padded_w > m_page_width) || (padded_h > m_page_height))
+    {
+        // Image too big for a standard page, store it in a dedicated page
+        page* p = create_page(w, h);
+        if (p)
+        {
+            p->skyline[0].y = h;
+            region.source   = p->contents;
+            region.rect     = {0, 0, w, h};
+            ret             = true;
+        }
+    }
+    else
+    {
+        // Look for an existing page with enough space
+        for (auto& p : m_pages)
+        {
+            size_t    node_index = 0;
+            SDL_Point position{0, 0};
+            if (find_position(p, padded_w, padded_h, node_index, position))
+            {
+                update_skyline(p, node_index, {position.x, position.y, padded_w, padded_h});
+                region.source = p.contents;
+                region.rect   = {position.x, position.y, w, h};
+                ret           = true;
+                break;
+            }
+        }
+        if (!ret)
+        {
+            // Create a new page
+            page* p = create_page(m_page_width, m_page_height);
+            if (p)
+            {
+                update_skyline(*p, 0, {0, 0, padded_w, padded_h});
+                region.source = p->contents;
+                region.rect   = {0, 0, w, h};
+                ret           = true;
+            }
+        }
+    }
+
+    return ret;
+}
+
+/** @brief Look for the lowest position where an area fits on the skyline of a page */
+bool sdl_texture_atlas::find_position(const page& p, int w, int h, size_t& node_index, SDL_Point& position) const
+{
+    bool ret         = false;
+    int  best_bottom = INT_MAX;
+    int  best_width  = INT_MAX;
+
+    // Bottom-left heuristic : keep the position which leaves the lowest skyline,
+    // and in case of equality the one which wastes the narrowest segment
+    for (size_t i = 0; i < p.skyline.size(); i++)
+    {
+        int y = 0;
+        if (fit(p, i, w, h, y))
+        {
+            int bottom = y + h;
+            if ((bottom < best_bottom) || ((bottom == best_bottom) && (p.skyline[i].w < best_width)))
+            {
+                best_bottom = bottom;
+                best_width  = p.skyline[i].w;
+                node_index  = i;
+                position    = {p.skyline[i].x, y};
+                ret         = true;
+            }
+        }
+    }
+
+    return ret;
+}
+
+/** @brief Check if an area fits on the skyline of a page starting at a given segment */
+bool sdl_texture_atlas::fit(const page& p, size_t node_index, int w, int h, int& y) const
+{
+    bool ret = false;
+
+    int x = p.skyline[node_index].x;
+    if ((x + w) <= p.w)
+    {
+        // The area lies on top of the highest segment it spans
+        int width_left = w;
+        y              = p.skyline[node_index].y;
+        ret            = true;
+        for (size_t i = node_index; ret && (width_left > 0); i++)
+        {
+            if (i < p.skyline.size())
+            {
+                if (p.skyline[i].y > y)
+                {
+                    y = p.skyline[i].y;
+                }
+                ret = ((y + h) <= p.h);
+                width_left -= p.skyline[i].w;
+            }
+            else
+            {
+                ret = false;
+            }
+        }
+    }
+
+    return ret;
+}
+
+/** @brief Update the skyline of a page after an area has been allocated */
+void sdl_texture_atlas::update_skyline(page& p, size_t node_index, const SDL_Rect& rect)
+{
+    // Insert the new segment on top of the allocated area
+    auto& skyline = p.skyline;
+    skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(node_index), {rect.x, rect.y + rect.h, rect.w});
+
+    // Shrink or remove the segments covered by the new one
+    for (size_t i = node_index + 1; i < skyline.size();)
+    {
+        const skyline_node& previous = skyline[i - 1];
+        int                 overlap  = (previous.x + previous.w) - skyline[i].x;
+        if (overlap <= 0)
+        {
+            break;
+        }
+        skyline[i].x += overlap;
+        skyline[i].w -= overlap;
+        if (skyline[i].w > 0)
+        {
+            break;
+        }
+        skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+
+    // Merge adjacent segments at the same height
+    for (size_t i = 0; (i + 1) < skyline.size();)
+    {
+        if (skyline[i].y == skyline[i + 1].y)
+        {
+            skyline[i].w += skyline[i + 1].w;
+            skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+} // namespace sdl
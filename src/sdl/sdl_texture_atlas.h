@@ -0,0 +1,152 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SDL_TEXTURE_ATLAS_H
+#define SDL_TEXTURE_ATLAS_H
+
+#include <SDL2/SDL.h>
+#include <memory>
+#include <vector>
+
+#include "sdl_renderer.h"
+
+namespace sdl
+{
+
+// Forward declarations
+class sdl_texture_atlas;
+
+/** @brief SDL texture atlas */
+using texture_atlas = std::shared_ptr<sdl_texture_atlas>;
+
+/**
+ * @brief Create a texture atlas
+ * @param renderer Renderer which will own the textures of the atlas
+ * @param page_width Width of a page of the atlas
+ * @param page_height Height of a page of the atlas
+ * @return SDL texture atlas object if the creation was successfull, nullptr otherwise
+ */
+texture_atlas create_texture_atlas(const renderer& renderer, int page_width, int page_height);
+
+/** @brief Texture atlas packing multiple images into a few large textures (pages) using a skyline algorithm */
+class sdl_texture_atlas
+{
+  public:
+    /**
+     * @brief Create a texture atlas
+     * @param renderer Renderer which will own the textures of the atlas
+     * @param page_width Width of a page of the atlas
+     * @param page_height Height of a page of the atlas
+     * @return SDL texture atlas object if the creation was successfull, nullptr otherwise
+     */
+    static texture_atlas create(const renderer& renderer, int page_width, int page_height);
+
+    /** @brief Destructor */
+    ~sdl_texture_atlas();
+
+    /**
+     * @brief Add an image to the atlas
+     * @param image Image to add
+     * @param region Region of the atlas where the image has been stored
+     * @return true if the image has been added, false otherwise
+     */
+    bool add(const surface& image, texture_region& region);
+
+    /**
+     * @brief Add raw pixels to the atlas
+     * @param pixels Pixels in the format of the pages (see get_format())
+     * @param pitch Number of bytes in a row of pixels
+     * @param w Width of the image
+     * @param h Height of the image
+     * @param region Region of the atlas where the image has been stored
+     * @return true if the image has been added, false otherwise
+     */
+    bool add(const void* pixels, int pitch, int w, int h, texture_region& region);
+
+    /** @brief Get the pixel format of the pages */
+    Uint32 get_format() const { return m_format; }
+
+    /** @brief Get the number of pages of the atlas */
+    size_t get_page_count() const { return m_pages.size(); }
+    /** @brief Get a page of the atlas */
+    const texture& get_page(size_t index) const { return m_pages[index].contents; }
+    /** @brief Get the size of a standard page of the atlas */
+    SDL_Rect get_page_size() const { return SDL_Rect{0, 0, m_page_width, m_page_height}; }
+
+  private:
+    /** @brief Segment of the skyline of a page */
+    struct skyline_node
+    {
+        /** @brief Start of the segment */
+        int x;
+        /** @brief Height of the segment */
+        int y;
+        /** @brief Width of the segment */
+        int w;
+    };
+
+    /** @brief Page of the atlas */
+    struct page
+    {
+        /** @brief Texture holding the contents of the page */
+        texture contents;
+        /** @brief Width of the page */
+        int w;
+        /** @brief Height of the page */
+        int h;
+        /** @brief Skyline describing the occupied area of the page */
+        std::vector<skyline_node> skyline;
+    };
+
+    /** @brief Empty space kept around each image to avoid bleeding when filtering */
+    static constexpr int PADDING = 1;
+
+    /** @brief Renderer which owns the textures of the atlas */
+    renderer m_renderer;
+    /** @brief Width of a standard page */
+    int m_page_width;
+    /** @brief Height of a standard page */
+    int m_page_height;
+    /** @brief Pixel format of the pages */
+    Uint32 m_format;
+    /** @brief Pages of the atlas */
+    std::vector<page> m_pages;
+
+    /** 
+     * @brief Constructor 
+     * @param renderer Renderer which will own the textures of the atlas
+     * @param page_width Width of a page of the atlas
+     * @param page_height Height of a page of the atlas
+     */
+    sdl_texture_atlas(const renderer& renderer, int page_width, int page_height);
+
+    /** @brief Create a new empty page */
+    page* create_page(int w, int h);
+    /** @brief Allocate an area in the pages of the atlas */
+    bool allocate(int w, int h, texture_region& region);
+    /** @brief Look for the lowest position where an area fits on the skyline of a page */
+    bool find_position(const page& p, int w, int h, size_t& node_index, SDL_Point& position) const;
+    /** @brief Check if an area fits on the skyline of a page starting at a given segment */
+    bool fit(const page& p, size_t node_index, int w, int h, int& y) const;
+    /** @brief Update the skyline of a page after an area has been allocated */
+    void update_skyline(page& p, size_t node_index, const SDL_Rect& rect);
+};
+
+} // namespace sdl
+
+#endif // SDL_TEXTURE_ATLAS_H
@@ -0,0 +1,193 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sdl_texture_loader.h"
+
+namespace sdl
+{
+
+/** @brief Create an asynchronous texture loader */
+texture_loader create_texture_loader(const renderer& renderer, size_t thread_count)
+{
+    return sdl_texture_loader::create(renderer, thread_count);
+}
+
+/** @brief Create an asynchronous texture loader */
+texture_loader sdl_texture_loader::create(const renderer& renderer, size_t thread_count)
+{
+    texture_loader instance;
+    if (renderer)
+    {
+        auto p = new sdl_texture_loader(renderer, thread_count);
+        instance.reset(p);
+    }
+    return instance;
+}
+
+/** @brief Destructor */
+sdl_texture_loader::~sdl_texture_loader()
+{
+    // Release the waiting requests
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& req : m_requests)
+    {
+        if (req->result)
+        {
+            req->result->set_value(nullptr);
+        }
+    }
+    m_requests.clear();
+}
+
+/** @brief Constructor */
+sdl_texture_loader::sdl_texture_loader(const renderer& renderer, size_t thread_count)
+    : m_renderer(renderer),
+      m_mutex(),
+      m_requests(),
+      m_max_upload_bytes(0),
+      m_max_upload_duration(std::chrono::microseconds(2000)),
+      m_pool(thread_count)
+{
+}
+
+/** @brief Load a texture from an image file */
+std::shared_future<texture> sdl_texture_loader::load(const std::string& file)
+{
+    auto                        result = std::make_shared<std::promise<texture>>();
+    std::shared_future<texture> ret(result->get_future());
+    submit(file,
+           [this, result](const surface& image)
+           {
+               texture contents;
+               if (image)
+               {
+                   contents = m_renderer->create_texture(image);
+               }
+               result->set_value(contents);
+           },
+           result);
+    return ret;
+}
+
+/** @brief Decode an image file and upload it with a custom handler */
+void sdl_texture_loader::load(const std::string& file, upload_handler handler)
+{
+    submit(file, handler, nullptr);
+}
+
+/** @brief Queue a handler called once all the previously submitted images have been uploaded */
+void sdl_texture_loader::post(upload_handler handler)
+{
+    auto req        = std::make_shared<request>();
+    req->is_decoded = true;
+    req->handler    = handler;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_requests.push_back(req);
+}
+
+/** @brief Queue a request and its decoding job */
+void sdl_texture_loader::submit(const std::string& file, upload_handler handler, const std::shared_ptr<std::promise<texture>>& result)
+{
+    auto req        = std::make_shared<request>();
+    req->file       = file;
+    req->is_decoded = false;
+    req->handler    = handler;
+    req->result     = result;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requests.push_back(req);
+    }
+    m_pool.post(
+        [this, req]
+        {
+            surface image = create_surface(req->file);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            req->image      = image;
+            req->is_decoded = true;
+        });
+}
+
+/** @brief Decode an image file without uploading it to a texture */
+std::shared_future<surface> sdl_texture_loader::decode(const std::string& file)
+{
+    auto                        result = std::make_shared<std::promise<surface>>();
+    std::shared_future<surface> ret(result->get_future());
+    m_pool.post([file, result] { result->set_value(create_surface(file)); });
+    return ret;
+}
+
+/** @brief Set the budget of each call to upload() */
+void sdl_texture_loader::set_upload_budget(size_t max_bytes, std::chrono::microseconds max_duration)
+{
+    m_max_upload_bytes    = max_bytes;
+    m_max_upload_duration = max_duration;
+}
+
+/** @brief Upload the decoded images to textures in submission order */
+size_t sdl_texture_loader::upload()
+{
+    size_t count          = 0;
+    size_t bytes          = 0;
+    auto   start          = std::chrono::steady_clock::now();
+    bool   is_budget_left = true;
+    while (is_budget_left)
+    {
+        // Next request in submission order
+        std::shared_ptr<request> req;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_requests.empty() && m_requests.front()->is_decoded)
+            {
+                req = m_requests.front();
+                m_requests.pop_front();
+            }
+        }
+        if (req)
+        {
+            // Upload
+            if (req->image)
+            {
+                SDL_Rect size = req->image->get_size();
+                bytes += static_cast<size_t>(size.w) * static_cast<size_t>(size.h) * req->image->get_pixel_format()->BytesPerPixel;
+            }
+            req->handler(req->image);
+            count++;
+
+            // Check budget
+            auto elapsed   = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+            is_budget_left = (((m_max_upload_bytes == 0) || (bytes < m_max_upload_bytes)) &&
+                              ((m_max_upload_duration.count() == 0) || (elapsed < m_max_upload_duration)));
+        }
+        else
+        {
+            is_budget_left = false;
+        }
+    }
+    return count;
+}
+
+/** @brief Get the number of textures which have not been uploaded yet */
+size_t sdl_texture_loader::get_pending_count() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_requests.size();
+}
+
+} // namespace sdl
@@ -0,0 +1,165 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SDL_TEXTURE_LOADER_H
+#define SDL_TEXTURE_LOADER_H
+
+#include <SDL2/SDL.h>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "sdl_renderer.h"
+#include "sdl_thread_pool.h"
+
+namespace sdl
+{
+
+// Forward declarations
+class sdl_texture_loader;
+
+/** @brief SDL texture loader */
+using texture_loader = std::shared_ptr<sdl_texture_loader>;
+
+/**
+ * @brief Create an asynchronous texture loader
+ * @param renderer Renderer which will own the loaded textures
+ * @param thread_count Number of decoding threads (0 to use the number of available cores)
+ * @return SDL texture loader object if the creation was successfull, nullptr otherwise
+ */
+texture_loader create_texture_loader(const renderer& renderer, size_t thread_count = 0);
+
+/** @brief Asynchronous texture loader: images are decoded by a pool of worker threads
+ *         and uploaded to textures on the rendering thread within a per-frame budget */
+class sdl_texture_loader
+{
+  public:
+    /** @brief Handler called on the rendering thread to upload a decoded image (nullptr if the image could not be decoded) */
+    using upload_handler = std::function<void(const surface& image)>;
+
+    /**
+     * @brief Create an asynchronous texture loader
+     * @param renderer Renderer which will own the loaded textures
+     * @param thread_count Number of decoding threads (0 to use the number of available cores)
+     * @return SDL texture loader object if the creation was successfull, nullptr otherwise
+     */
+    static texture_loader create(const renderer& renderer, size_t thread_count);
+
+    /** @brief Destructor, the pending handlers are not called and the textures which have not been uploaded resolve to nullptr */
+    ~sdl_texture_loader();
+
+    /** @brief Copy constructor => deleted */
+    sdl_texture_loader(const sdl_texture_loader& copy) = delete;
+    /** @brief Copy assignment => deleted */
+    sdl_texture_loader& operator=(const sdl_texture_loader& copy) = delete;
+
+    /**
+     * @brief Load a texture from an image file
+     *        The returned future is ready once the texture has been uploaded by upload(): it must not
+     *        be waited for on the rendering thread before upload() has been called
+     * @param file Path to the image file
+     * @return Future resolving to the texture, or to nullptr if the image could not be loaded
+     */
+    std::shared_future<texture> load(const std::string& file);
+
+    /**
+     * @brief Decode an image file without uploading it to a texture
+     * @param file Path to the image file
+     * @return Future resolving to the decoded surface, or to nullptr if the image could not be decoded
+     */
+    std::shared_future<surface> decode(const std::string& file);
+
+    /**
+     * @brief Decode an image file and upload it with a custom handler (ex: to pack it into a texture atlas)
+     *        The handler is called by upload() in submission order
+     * @param file Path to the image file
+     * @param handler Handler to call with the decoded image
+     */
+    void load(const std::string& file, upload_handler handler);
+
+    /**
+     * @brief Queue a handler called by upload() once all the previously submitted images have been uploaded
+     *        (ex: completion notification of a batch of images)
+     * @param handler Handler to call with a nullptr image
+     */
+    void post(upload_handler handler);
+
+    /**
+     * @brief Set the budget of each call to upload()
+     * @param max_bytes Maximum number of bytes to upload (0 for no limit)
+     * @param max_duration Maximum duration of the uploads (0 for no limit)
+     */
+    void set_upload_budget(size_t max_bytes, std::chrono::microseconds max_duration);
+
+    /**
+     * @brief Upload the decoded images to textures in submission order, must be called on the rendering thread
+     *        At least one image is uploaded if one is ready, then the uploads stop when the budget is exhausted
+     * @return Number of uploaded textures
+     */
+    size_t upload();
+
+    /** @brief Get the number of textures which have not been uploaded yet */
+    size_t get_pending_count() const;
+
+  private:
+    /** @brief Texture load request */
+    struct request
+    {
+        /** @brief Path to the image file */
+        std::string file;
+        /** @brief Indicate if the image has been decoded */
+        bool is_decoded;
+        /** @brief Decoded image */
+        surface image;
+        /** @brief Upload handler */
+        upload_handler handler;
+        /** @brief Texture promised by load() (nullptr for the custom handlers) */
+        std::shared_ptr<std::promise<texture>> result;
+    };
+
+    /** @brief Renderer which will own the loaded textures */
+    renderer m_renderer;
+    /** @brief Protection of the requests */
+    mutable std::mutex m_mutex;
+    /** @brief Requests waiting for upload in submission order */
+    std::deque<std::shared_ptr<request>> m_requests;
+    /** @brief Maximum number of bytes uploaded by a call to upload() */
+    size_t m_max_upload_bytes;
+    /** @brief Maximum duration of a call to upload() */
+    std::chrono::microseconds m_max_upload_duration;
+    /** @brief Decoding threads (declared last to be stopped first) */
+    sdl_thread_pool m_pool;
+
+    /** @brief Queue a request and its decoding job */
+    void submit(const std::string& file, upload_handler handler, const std::shared_ptr<std::promise<texture>>& result);
+
+    /**
+     * @brief Constructor
+     * @param renderer Renderer which will own the loaded textures
+     * @param thread_count Number of decoding threads
+     */
+    sdl_texture_loader(const renderer& renderer, size_t thread_count);
+};
+
+} // namespace sdl
+
+#endif // SDL_TEXTURE_LOADER_H
@@ -0,0 +1,131 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sdl_texture_pool.h"
+#include "sdl_renderer.h"
+
+namespace sdl
+{
+
+/** @brief Create a texture pool */
+texture_pool sdl_texture_pool::create(sdl_renderer& renderer)
+{
+    auto p = new sdl_texture_pool(renderer);
+    return texture_pool(p);
+}
+
+/** @brief Constructor */
+sdl_texture_pool::sdl_texture_pool(sdl_renderer& renderer)
+    : m_renderer(renderer), m_idle(), m_idle_bytes(0), m_high_water_mark(DEFAULT_HIGH_WATER_MARK), m_hits(0), m_misses(0)
+{
+}
+
+/** @brief Acquire a texture from the pool, or create it if no matching texture is available */
+bool sdl_texture_pool::acquire(Uint32 format, int access, int w, int h, texture_region& region)
+{
+    bool ret = false;
+    if ((w > 0) && (h > 0))
+    {
+        // Compute size class
+        int class_w = ((w + SIZE_GRANULARITY - 1) / SIZE_GRANULARITY) * SIZE_GRANULARITY;
+        int class_h = ((h + SIZE_GRANULARITY - 1) / SIZE_GRANULARITY) * SIZE_GRANULARITY;
+
+        // Look for the most recently released matching texture
+        texture       contents;
+        SDL_ScaleMode scale_mode = SDL_ScaleModeNearest;
+        for (auto iter = m_idle.rbegin(); iter != m_idle.rend(); ++iter)
+        {
+            if ((iter->format == format) && (iter->access == access) && (iter->w == class_w) && (iter->h == class_h))
+            {
+                contents   = iter->contents;
+                scale_mode = iter->scale_mode;
+                m_idle_bytes -= contents->get_memory_size();
+                m_idle.erase(std::next(iter).base());
+                m_hits++;
+                break;
+            }
+        }
+        if (!contents)
+        {
+            // Keep the filtering given by the renderer to restore it when the texture is released
+            contents = m_renderer.create_texture(format, access, class_w, class_h);
+            if (contents)
+            {
+                contents->get_scale_mode(scale_mode);
+            }
+            m_misses++;
+        }
+        if (contents)
+        {
+            // The texture goes back to the pool when the last reference is released, or is destroyed with the pool
+            std::weak_ptr<sdl_texture_pool> pool     = weak_from_this();
+            auto                            recycler = [pool, format, access, class_w, class_h, scale_mode, contents](sdl_texture*) mutable
+            {
+                auto owner = pool.lock();
+                if (owner)
+                {
+                    owner->release(format, access, class_w, class_h, scale_mode, std::move(contents));
+                }
+                contents.reset();
+            };
+            region.source = texture(contents.get(), recycler);
+            region.rect   = {0, 0, w, h};
+            ret           = true;
+        }
+    }
+    return ret;
+}
+
+/** @brief Set the maximum number of bytes of the unused textures kept in the pool */
+void sdl_texture_pool::set_high_water_mark(Uint64 max_bytes)
+{
+    m_high_water_mark = max_bytes;
+    shrink(m_high_water_mark);
+}
+
+/** @brief Destroy all the unused textures */
+void sdl_texture_pool::trim()
+{
+    shrink(0);
+}
+
+/** @brief Give back a texture to the pool */
+void sdl_texture_pool::release(Uint32 format, int access, int w, int h, SDL_ScaleMode scale_mode, texture contents)
+{
+    // Reset the state modified by the previous user
+    contents->set_blend_mode(SDL_BLENDMODE_NONE);
+    contents->set_color_mod(255u, 255u, 255u);
+    contents->set_alpha_mod(255u);
+    contents->set_scale_mode(scale_mode);
+
+    m_idle_bytes += contents->get_memory_size();
+    m_idle.push_back({format, access, w, h, scale_mode, std::move(contents)});
+    shrink(m_high_water_mark);
+}
+
+/** @brief Destroy the oldest unused textures until the pool is below a number of bytes */
+void sdl_texture_pool::shrink(Uint64 max_bytes)
+{
+    while (!m_idle.empty() && (m_idle_bytes > max_bytes))
+    {
+        m_idle_bytes -= m_idle.front().contents->get_memory_size();
+        m_idle.pop_front();
+    }
+}
+
+} // namespace sdl
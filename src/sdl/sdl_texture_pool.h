@@ -0,0 +1,133 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SDL_TEXTURE_POOL_H
+#define SDL_TEXTURE_POOL_H
+
+#include <SDL2/SDL.h>
+#include <list>
+#include <memory>
+
+#include "sdl_texture.h"
+
+namespace sdl
+{
+
+// Forward declarations
+class sdl_renderer;
+class sdl_texture_pool;
+
+/** @brief SDL texture pool */
+using texture_pool = std::shared_ptr<sdl_texture_pool>;
+
+/** @brief Pool recycling the textures of a renderer by format, access and size class
+ *         (ex: intermediate textures of the widgets which are rebuilt frequently) */
+class sdl_texture_pool : public std::enable_shared_from_this<sdl_texture_pool>
+{
+    // SDL renderer wrapper is friend to allow constructing a texture pool
+    friend class sdl_renderer;
+
+  public:
+    /** @brief Granularity in pixels of the size classes */
+    static constexpr int SIZE_GRANULARITY = 32;
+    /** @brief Default maximum number of bytes of the unused textures kept in the pool */
+    static constexpr Uint64 DEFAULT_HIGH_WATER_MARK = 32u * 1024u * 1024u;
+
+    /** @brief Destructor */
+    ~sdl_texture_pool() = default;
+
+    /** @brief Copy constructor => deleted */
+    sdl_texture_pool(const sdl_texture_pool& copy) = delete;
+    /** @brief Copy assignment => deleted */
+    sdl_texture_pool& operator=(const sdl_texture_pool& copy) = delete;
+
+    /**
+     * @brief Acquire a texture from the pool, or create it if no matching texture is available
+     *        The texture goes back to the pool once it is no longer referenced, its blend mode is then reset
+     * @param format Color format
+     * @param access Access restrictions
+     * @param w Width of the texture
+     * @param h Height of the texture
+     * @param region Texture and area of the texture of the requested size (the texture can be larger)
+     * @return true if a texture has been acquired, false otherwise
+     */
+    bool acquire(Uint32 format, int access, int w, int h, texture_region& region);
+
+    /** @brief Set the maximum number of bytes of the unused textures kept in the pool, the oldest ones are destroyed above */
+    void set_high_water_mark(Uint64 max_bytes);
+    /** @brief Get the maximum number of bytes of the unused textures kept in the pool */
+    Uint64 get_high_water_mark() const { return m_high_water_mark; }
+
+    /** @brief Destroy all the unused textures */
+    void trim();
+
+    /** @brief Get the number of unused textures in the pool */
+    size_t get_idle_count() const { return m_idle.size(); }
+    /** @brief Get the number of bytes of the unused textures in the pool */
+    Uint64 get_idle_bytes() const { return m_idle_bytes; }
+    /** @brief Get the number of acquisitions which have reused a texture */
+    Uint64 get_hit_count() const { return m_hits; }
+    /** @brief Get the number of acquisitions which have created a texture */
+    Uint64 get_miss_count() const { return m_misses; }
+
+  private:
+    /** @brief Unused texture */
+    struct idle_texture
+    {
+        /** @brief Color format */
+        Uint32 format;
+        /** @brief Access restrictions */
+        int access;
+        /** @brief Width of the size class */
+        int w;
+        /** @brief Height of the size class */
+        int h;
+        /** @brief Filtering of the texture when it has been created */
+        SDL_ScaleMode scale_mode;
+        /** @brief Texture */
+        texture contents;
+    };
+
+    /** @brief Renderer which owns the textures */
+    sdl_renderer& m_renderer;
+    /** @brief Unused textures, from the least to the most recently released */
+    std::list<idle_texture> m_idle;
+    /** @brief Number of bytes of the unused textures */
+    Uint64 m_idle_bytes;
+    /** @brief Maximum number of bytes of the unused textures */
+    Uint64 m_high_water_mark;
+    /** @brief Number of acquisitions which have reused a texture */
+    Uint64 m_hits;
+    /** @brief Number of acquisitions which have created a texture */
+    Uint64 m_misses;
+
+    /** @brief Create a texture pool */
+    static texture_pool create(sdl_renderer& renderer);
+
+    /** @brief Constructor */
+    sdl_texture_pool(sdl_renderer& renderer);
+
+    /** @brief Give back a texture to the pool */
+    void release(Uint32 format, int access, int w, int h, SDL_ScaleMode scale_mode, texture contents);
+    /** @brief Destroy the oldest unused textures until the pool is below a number of bytes */
+    void shrink(Uint64 max_bytes);
+};
+
+} // namespace sdl
+
+#endif // SDL_TEXTURE_POOL_H
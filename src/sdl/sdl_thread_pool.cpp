@@ -0,0 +1,93 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sdl_thread_pool.h"
+
+namespace sdl
+{
+
+/** @brief Constructor */
+sdl_thread_pool::sdl_thread_pool(size_t thread_count) : m_mutex(), m_wakeup(), m_jobs(), m_is_stopping(false), m_threads()
+{
+    if (thread_count == 0)
+    {
+        thread_count = std::thread::hardware_concurrency();
+        if (thread_count == 0)
+        {
+            thread_count = 1u;
+        }
+    }
+    for (size_t i = 0; i < thread_count; i++)
+    {
+        m_threads.emplace_back(&sdl_thread_pool::run, this);
+    }
+}
+
+/** @brief Destructor */
+sdl_thread_pool::~sdl_thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_is_stopping = true;
+    }
+    m_wakeup.notify_all();
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+/** @brief Queue a job for execution */
+void sdl_thread_pool::post(job new_job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(new_job));
+    }
+    m_wakeup.notify_one();
+}
+
+/** @brief Worker thread loop */
+void sdl_thread_pool::run()
+{
+    bool is_running = true;
+    while (is_running)
+    {
+        job next_job;
+        {
+            // Wait for a job, the remaining jobs are executed before stopping
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeup.wait(lock, [this] { return (m_is_stopping || !m_jobs.empty()); });
+            if (!m_jobs.empty())
+            {
+                next_job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+            else
+            {
+                is_running = false;
+            }
+        }
+        if (next_job)
+        {
+            next_job();
+        }
+    }
+}
+
+} // namespace sdl
@@ -0,0 +1,76 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SDL_THREAD_POOL_H
+#define SDL_THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sdl
+{
+
+/** @brief Pool of worker threads executing jobs in submission order */
+class sdl_thread_pool
+{
+  public:
+    /** @brief Job executed by the pool */
+    using job = std::function<void()>;
+
+    /**
+     * @brief Constructor
+     * @param thread_count Number of worker threads (0 to use the number of available cores)
+     */
+    sdl_thread_pool(size_t thread_count = 0);
+    /** @brief Destructor, the queued jobs are executed before the worker threads are stopped */
+    ~sdl_thread_pool();
+
+    /** @brief Copy constructor => deleted */
+    sdl_thread_pool(const sdl_thread_pool& copy) = delete;
+    /** @brief Copy assignment => deleted */
+    sdl_thread_pool& operator=(const sdl_thread_pool& copy) = delete;
+
+    /** @brief Queue a job for execution */
+    void post(job new_job);
+
+    /** @brief Get the number of worker threads */
+    size_t get_thread_count() const { return m_threads.size(); }
+
+  private:
+    /** @brief Protection of the queue */
+    std::mutex m_mutex;
+    /** @brief Signaled when a job is queued or when the pool is stopping */
+    std::condition_variable m_wakeup;
+    /** @brief Queued jobs */
+    std::deque<job> m_jobs;
+    /** @brief Indicate if the pool is stopping */
+    bool m_is_stopping;
+    /** @brief Worker threads */
+    std::vector<std::thread> m_threads;
+
+    /** @brief Worker thread loop */
+    void run();
+};
+
+} // namespace sdl
+
+#endif // SDL_THREAD_POOL_H
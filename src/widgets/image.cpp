@@ -22,19 +22,30 @@ namespace widgets
 {
 
 /** @brief Constructor */
-image::image(sdl::renderer& renderer) : widget(renderer), m_image(), m_image_size{0, 0, 0, 0}, m_image_ratio(1.f) { }
+image::image(sdl::renderer& renderer)
+    : widget(renderer), m_image(), m_image_rect{0, 0, 0, 0}, m_image_size{0, 0, 0, 0}, m_image_offset{0, 0}, m_image_ratio(1.f)
+{
+}
 
 /** @brief Copy constructor */
 image::image(const image& copy)
-    : widget(copy.m_renderer), m_image(copy.m_image), m_image_size(copy.m_image_size), m_image_ratio(copy.m_image_ratio)
+    : widget(copy.m_renderer),
+      m_image(copy.m_image),
+      m_image_rect(copy.m_image_rect),
+      m_image_size(copy.m_image_size),
+      m_image_offset(copy.m_image_offset),
+      m_image_ratio(copy.m_image_ratio)
 {
 }
 
 /** @brief Copy assignment */
 image& image::operator=(const image& copy)
 {
-    m_image      = copy.m_image;
-    m_image_size = copy.m_image_size;
+    m_image        = copy.m_image;
+    m_image_rect   = copy.m_image_rect;
+    m_image_size   = copy.m_image_size;
+    m_image_offset = copy.m_image_offset;
+    m_image_ratio  = copy.m_image_ratio;
     update_needed();
     return (*this);
 }
@@ -46,8 +57,34 @@ bool image::load(const std::string& file)
     m_image  = m_renderer->create_texture(file);
     if (m_image)
     {
-        m_image_size  = m_image->get_size();
-        m_image_ratio = static_cast<float>(m_image_size.w) / static_cast<float>(m_image_size.h);
+        m_image_size   = m_image->get_size();
+        m_image_rect   = m_image_size;
+        m_image_offset = {0, 0};
+        m_image_ratio  = static_cast<float>(m_image_size.w) / static_cast<float>(m_image_size.h);
+        update_needed();
+        ret = true;
+    }
+    return ret;
+}
+
+/** @brief Load the image from a region of a texture (ex: texture atlas) */
+bool image::load(const sdl::texture_region& region)
+{
+    return load(region, SDL_Rect{0, 0, region.rect.w, region.rect.h});
+}
+
+/** @brief Load a trimmed image from a region of a texture (ex: texture atlas) */
+bool image::load(const sdl::texture_region& region, const SDL_Rect& frame)
+{
+    bool ret = false;
+    if (region.source && (region.rect.w > 0) && (region.rect.h > 0) && (frame.x >= 0) && (frame.y >= 0) &&
+        ((frame.x + region.rect.w) <= frame.w) && ((frame.y + region.rect.h) <= frame.h))
+    {
+        m_image        = region.source;
+        m_image_rect   = region.rect;
+        m_image_size   = {0, 0, frame.w, frame.h};
+        m_image_offset = {frame.x, frame.y};
+        m_image_ratio  = static_cast<float>(m_image_size.w) / static_cast<float>(m_image_size.h);
         update_needed();
         ret = true;
     }
@@ -69,54 +106,92 @@ void image::update_texture()
     m_position.w = img_size.w;
     m_position.h = img_size.h;
 
-    // Create image texture
-    m_texture = m_renderer->create_texture(SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, img_size.w, img_size.h);
-    if (m_texture)
+    if (m_image && can_draw_direct())
     {
-        // Prepare texture for rendering
-        m_texture->set_blend_mode(SDL_BLENDMODE_BLEND);
-        m_renderer->push_texture(m_texture);
-
-        // Fill background
-        m_renderer->set_draw_color(m_bg_color);
-        m_renderer->clear();
+        // Draw the image directly from its source texture
+        set_direct_texture(m_image, m_image_rect, compute_image_dest(img_size));
+    }
+    else
+    {
+        // When the image is displayed at its own size over a transparent background,
+        // the texture only needs to cover its non transparent area
+        SDL_Rect tex_size   = img_size;
+        bool     is_trimmed = (m_image && m_is_autosized && (m_bg_color.a == 0) &&
+                           ((m_image_rect.w != m_image_size.w) || (m_image_rect.h != m_image_size.h)));
+        if (is_trimmed)
+        {
+            tex_size       = {0, 0, m_image_rect.w, m_image_rect.h};
+            m_texture_area = {m_image_offset.x, m_image_offset.y, m_image_rect.w, m_image_rect.h};
+        }
 
-        // Put the image over
-        if (m_image)
+        // Create image texture
+        if (create_target_texture(tex_size.w, tex_size.h))
         {
-            if (m_is_autosized)
-            {
-                m_renderer->copy(m_image, nullptr, &img_size);
-            }
-            else
+            // Prepare texture for rendering
+            m_renderer->push_texture(m_texture);
+
+            // Fill background
+            m_renderer->set_draw_color(m_bg_color);
+            m_renderer->clear();
+
+            // Put the image over
+            if (m_image)
             {
-                // Compute the image size
-                if (m_adjust == adjust::none)
-                {
-                    img_size = m_image_size;
-                }
-                else if (m_adjust == adjust::width)
-                {
-                    img_size.h = static_cast<int>(static_cast<float>(img_size.w) / m_image_ratio);
-                }
-                else if (m_adjust == adjust::height)
-                {
-                    img_size.w = static_cast<int>(static_cast<float>(img_size.h) * m_image_ratio);
-                }
-                else
-                {
-                    // adjust::fit
-                }
-
-                // Compute the destination position
-                SDL_Rect dest = compute_alignment(img_size);
-                m_renderer->copy(m_image, nullptr, &dest);
+                SDL_Rect dest = (is_trimmed ? tex_size : compute_image_dest(img_size));
+                m_renderer->copy(m_image, &m_image_rect, &dest);
             }
+
+            // Restore renderer state
+            m_renderer->pop_texture();
         }
+    }
+}
 
-        // Restore renderer state
-        m_renderer->pop_texture();
+/** @brief Compute the position of the trimmed area in the widget */
+SDL_Rect image::compute_image_dest(SDL_Rect img_size)
+{
+    SDL_Rect dest;
+    if (m_is_autosized)
+    {
+        dest = compute_trimmed_dest(img_size);
     }
+    else
+    {
+        // Compute the image size
+        if (m_adjust == adjust::none)
+        {
+            img_size = m_image_size;
+        }
+        else if (m_adjust == adjust::width)
+        {
+            img_size.h = static_cast<int>(static_cast<float>(img_size.w) / m_image_ratio);
+        }
+        else if (m_adjust == adjust::height)
+        {
+            img_size.w = static_cast<int>(static_cast<float>(img_size.h) * m_image_ratio);
+        }
+        else
+        {
+            // adjust::fit
+        }
+
+        // Compute the destination position
+        dest = compute_trimmed_dest(compute_alignment(img_size));
+    }
+    return dest;
+}
+
+/** @brief Compute where the trimmed area must be drawn to place the untouched image in a destination area */
+SDL_Rect image::compute_trimmed_dest(const SDL_Rect& dest) const
+{
+    float    scale_x = static_cast<float>(dest.w) / static_cast<float>(m_image_size.w);
+    float    scale_y = static_cast<float>(dest.h) / static_cast<float>(m_image_size.h);
+    SDL_Rect trimmed;
+    trimmed.x = dest.x + static_cast<int>(static_cast<float>(m_image_offset.x) * scale_x);
+    trimmed.y = dest.y + static_cast<int>(static_cast<float>(m_image_offset.y) * scale_y);
+    trimmed.w = static_cast<int>(static_cast<float>(m_image_rect.w) * scale_x);
+    trimmed.h = static_cast<int>(static_cast<float>(m_image_rect.h) * scale_y);
+    return trimmed;
 }
 
 } // namespace widgets
@@ -42,6 +42,15 @@ class image : public widget
 
     /** @brief Load the image from a file */
     bool load(const std::string& file);
+    /** @brief Load the image from a region of a texture (ex: texture atlas) */
+    bool load(const sdl::texture_region& region);
+    /**
+     * @brief Load a trimmed image from a region of a texture (ex: texture atlas)
+     * @param region Region of the texture containing the non transparent part of the image
+     * @param frame Position of the region in the untrimmed image (x, y) and size of the untrimmed image (w, h)
+     * @return true if the image has been loaded, false otherwise
+     */
+    bool load(const sdl::texture_region& region, const SDL_Rect& frame);
 
     /** @brief Update the texture representing the widget */
     void update_texture() override;
@@ -49,10 +58,19 @@ class image : public widget
   private:
     /** @brief Texture representing the untouched image */
     sdl::texture m_image;
+    /** @brief Area of the texture containing the untouched image */
+    SDL_Rect m_image_rect;
     /** @brief Size of the untouched image */
     SDL_Rect m_image_size;
+    /** @brief Position of the trimmed area in the untouched image */
+    SDL_Point m_image_offset;
     /** @brief Ratio of the untouched image */
     float m_image_ratio;
+
+    /** @brief Compute the position of the trimmed area in the widget */
+    SDL_Rect compute_image_dest(SDL_Rect img_size);
+    /** @brief Compute where the trimmed area must be drawn to place the untouched image in a destination area */
+    SDL_Rect compute_trimmed_dest(const SDL_Rect& dest) const;
 };
 
 } // namespace widgets
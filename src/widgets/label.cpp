@@ -17,12 +17,24 @@ along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "label.h"
+#include "sdl_text_cache.h"
 
 namespace widgets
 {
 
 /** @brief Constructor */
-label::label(sdl::renderer& renderer) : widget(renderer), m_text(), m_font(), m_text_color{255, 255, 255, 0} { }
+label::label(sdl::renderer& renderer)
+    : widget(renderer),
+      m_text(),
+      m_font(),
+      m_glyph_atlas(),
+      m_text_color{255, 255, 255, 0},
+      m_text_scale(1.f),
+      m_wrap_length(0),
+      m_drawn_scaling(1.f),
+      m_text_size{0, 0, 0, 0}
+{
+}
 
 /** @brief Set the text to display */
 void label::set_text(const std::string& text)
@@ -38,6 +50,13 @@ void label::set_font(const sdl::font& font)
     update_needed();
 }
 
+/** @brief Set the glyph atlas to use to draw the text instead of rendering it with the font */
+void label::set_glyph_atlas(const sdl::glyph_atlas& atlas)
+{
+    m_glyph_atlas = atlas;
+    update_needed();
+}
+
 /** @brief Set the text color */
 void label::set_text_color(const SDL_Color& color)
 {
@@ -45,53 +64,214 @@ void label::set_text_color(const SDL_Color& color)
     update_needed();
 }
 
+/** @brief Set the scaling of the text size, only applied with a signed distance field glyph atlas */
+void label::set_text_scale(float scale)
+{
+    if (scale != m_text_scale)
+    {
+        // The glyphs are drawn again at the new size, none of them is rasterized again
+        m_text_scale = scale;
+        update_needed();
+    }
+}
+
+/** @brief Set the length in pixel before wrapping the text */
+void label::set_wrap_length(Uint32 wrap_length)
+{
+    if (wrap_length != m_wrap_length)
+    {
+        m_wrap_length = wrap_length;
+        update_needed();
+    }
+}
+
+/** @brief Compute the size of the text with the font without rendering it */
+SDL_Rect label::measure_text() const
+{
+    SDL_Rect size = {0, 0, 0, 0};
+    if (m_font)
+    {
+        size = m_font->measure(m_text, m_wrap_length);
+    }
+    return size;
+}
+
 /** @brief Update the texture representing the widget */
 void label::update_texture()
+{
+    if (m_glyph_atlas)
+    {
+        update_glyph_texture();
+    }
+    else
+    {
+        update_font_texture();
+    }
+}
+
+/** @brief Called once the animation has been applied, before the texture is updated if needed */
+void label::on_refresh()
+{
+    // Glyphs drawn directly follow the scaling of the transformation at each rendering,
+    // the texture of the label is only drawn again when switching from one mode to the other
+    // or when the scaling of the transformation changes instead of stretching the texture
+    if (m_glyph_atlas &&
+        ((can_draw_glyphs() != m_is_contents_drawn) || (!m_is_contents_drawn && (get_glyph_scaling() != m_drawn_scaling))))
+    {
+        update_needed();
+    }
+}
+
+/** @brief Update the texture by rendering the text with the font */
+void label::update_font_texture()
 {
     // Render text to a texture
     sdl::texture text_texture;
     if (m_font)
     {
-        auto text_surface = m_font->render_blended(m_text, m_text_color);
-        if (text_surface)
+        auto text_cache = m_font->get_text_cache();
+        if (text_cache)
         {
-            if (m_is_autosized)
+            // Texts are shared between all the labels using the same font
+            text_texture =
+                text_cache->render(m_renderer, m_font, m_text, m_text_color, sdl::sdl_text_cache::render_mode::blended, m_wrap_length);
+        }
+        else
+        {
+            auto text_surface = ((m_wrap_length != 0) ? m_font->render_blended_wrapped(m_text, m_text_color, m_wrap_length)
+                                                      : m_font->render_blended(m_text, m_text_color));
+            if (text_surface)
             {
-                m_size = text_surface->get_size();
+                text_texture = m_renderer->create_texture(text_surface);
             }
-            text_texture = m_renderer->create_texture(text_surface);
+        }
+        if (text_texture && m_is_autosized)
+        {
+            m_size = text_texture->get_size();
         }
     }
     m_position.w = m_size.w;
     m_position.h = m_size.h;
 
-    // Create label texture
-    m_texture = m_renderer->create_texture(SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, m_size.w, m_size.h);
-    if (m_texture)
+    // Compute the destination position based on alignment
+    SDL_Rect dest = {0, 0, 0, 0};
+    if (text_texture)
     {
-        // Prepare texture for rendering
-        m_texture->set_blend_mode(SDL_BLENDMODE_BLEND);
-        m_renderer->push_texture(m_texture);
-
-        // Fill background
-        m_renderer->set_draw_color(m_bg_color);
-        m_renderer->clear();
+        dest = text_texture->get_size();
+        if (!m_is_autosized)
+        {
+            dest = compute_alignment(dest);
+        }
+    }
 
-        // Put the text texture over
-        if (text_texture)
+    if (text_texture && can_draw_direct())
+    {
+        // Draw the text directly from its texture
+        set_direct_texture(text_texture, text_texture->get_size(), dest);
+    }
+    else
+    {
+        // Create label texture
+        if (create_target_texture(m_size.w, m_size.h))
         {
-            SDL_Rect dest = text_texture->get_size();
-            if (!m_is_autosized)
+            // Prepare texture for rendering
+            m_renderer->push_texture(m_texture);
+
+            // Fill background
+            m_renderer->set_draw_color(m_bg_color);
+            m_renderer->clear();
+
+            // Put the text texture over
+            if (text_texture)
             {
-                // Compute the destination position based on alignment
-                dest = compute_alignment(dest);
+                m_renderer->copy(text_texture, nullptr, &dest);
             }
-            m_renderer->copy(text_texture, nullptr, &dest);
+
+            // Restore renderer state
+            m_renderer->pop_texture();
+        }
+    }
+}
+
+/** @brief Update the texture by drawing the text with the glyph atlas */
+void label::update_glyph_texture()
+{
+    // Compute text size
+    m_text_size = m_glyph_atlas->measure(m_text, m_text_scale);
+    if (m_is_autosized)
+    {
+        m_size = m_text_size;
+    }
+    m_position.w = m_size.w;
+    m_position.h = m_size.h;
+
+    // Signed distance fields are drawn at the scaling of the transformation,
+    // the texture is then copied at its size instead of being stretched
+    float scaling   = get_glyph_scaling();
+    m_drawn_scaling = scaling;
+    if (can_draw_glyphs())
+    {
+        // The glyphs are drawn at each rendering, no texture is needed when the scaling changes
+        set_direct_contents();
+    }
+    else
+    {
+        // Draw the glyphs on the label texture, no rasterization nor upload is needed once the glyphs are in the atlas
+        int w = static_cast<int>(static_cast<float>(m_size.w) * scaling);
+        int h = static_cast<int>(static_cast<float>(m_size.h) * scaling);
+        if (create_target_texture(w, h))
+        {
+            m_renderer->push_texture(m_texture);
+
+            // Fill background
+            m_renderer->set_draw_color(m_bg_color);
+            m_renderer->clear();
+
+            // Draw the text
+            SDL_Rect dest = (m_is_autosized ? m_text_size : compute_alignment(m_text_size));
+            int      x    = static_cast<int>(static_cast<float>(dest.x) * scaling);
+            int      y    = static_cast<int>(static_cast<float>(dest.y) * scaling);
+            m_glyph_atlas->draw(m_text, x, y, m_text_color, m_text_scale * scaling);
+
+            // Restore renderer state
+            m_renderer->pop_texture();
         }
+    }
+}
 
-        // Restore renderer state
-        m_renderer->pop_texture();
+/** @brief Get the scaling of the transformation to apply when drawing the text with the glyph atlas */
+float label::get_glyph_scaling() const
+{
+    float scaling = 1.f;
+    if (m_glyph_atlas && m_glyph_atlas->is_sdf() && (m_transform.get_scaling() > 0.f))
+    {
+        scaling = m_transform.get_scaling();
+    }
+    return scaling;
+}
+
+/** @brief Draw the glyphs of the text directly at the scaling of the transformation */
+void label::draw_contents()
+{
+    float    scaling = get_glyph_scaling();
+    SDL_Rect dest    = (m_is_autosized ? m_text_size : compute_alignment(m_text_size));
+    int      x       = m_position.x + static_cast<int>(static_cast<float>(dest.x) * scaling);
+    int      y       = m_position.y + static_cast<int>(static_cast<float>(dest.y) * scaling);
+    m_glyph_atlas->draw(m_text, x, y, m_text_color, m_text_scale * scaling);
+}
+
+/** @brief Indicate if the glyphs can be drawn directly at each rendering instead of on the texture of the label */
+bool label::can_draw_glyphs() const
+{
+    // Only signed distance fields keep their quality at any scaling, the glyphs are neither rotated nor flipped
+    bool ret = (m_glyph_atlas && m_glyph_atlas->is_sdf() && can_draw_direct() && (m_transform.get_rot_angle() == 0.) &&
+                (m_transform.get_flip() == SDL_FLIP_NONE));
+    if (ret && !m_is_autosized)
+    {
+        // The glyphs are not clipped to the label
+        ret = ((m_text_size.w <= m_size.w) && (m_text_size.h <= m_size.h));
     }
+    return ret;
 }
 
 } // namespace widgets
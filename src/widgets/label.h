@@ -22,6 +22,7 @@ along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
 #include <string>
 
 #include "sdl_font.h"
+#include "sdl_glyph_atlas.h"
 #include "widget.h"
 
 namespace widgets
@@ -51,21 +52,62 @@ class label : public widget
     /** @brief Get the font to use */
     sdl::font get_font() const { return m_font; }
 
+    /** @brief Set the glyph atlas to use to draw the text instead of rendering it with the font (nullptr to use the font) */
+    void set_glyph_atlas(const sdl::glyph_atlas& atlas);
+    /** @brief Get the glyph atlas used to draw the text */
+    sdl::glyph_atlas get_glyph_atlas() const { return m_glyph_atlas; }
+
     /** @brief Set the text color */
     void set_text_color(const SDL_Color& color);
     /** @brief Get the text color */
     SDL_Color get_text_color() const { return m_text_color; }
+    /** @brief Set the scaling of the text size, only applied with a signed distance field glyph atlas
+     *         The glyphs of the atlas are drawn at the new size, none of them is rasterized again */
+    void set_text_scale(float scale);
+    /** @brief Get the scaling of the text size */
+    float get_text_scale() const { return m_text_scale; }
+    /** @brief Set the length in pixel before wrapping the text (0 to disable wrapping) */
+    void set_wrap_length(Uint32 wrap_length);
+    /** @brief Get the length in pixel before wrapping the text */
+    Uint32 get_wrap_length() const { return m_wrap_length; }
+    /** @brief Compute the size of the text with the font without rendering it */
+    SDL_Rect measure_text() const;
 
     /** @brief Update the texture representing the widget */
     void update_texture() override;
 
+  protected:
+    /** @brief Called once the animation has been applied, before the texture is updated if needed */
+    void on_refresh() override;
+    /** @brief Draw the glyphs of the text directly at the scaling of the transformation */
+    void draw_contents() override;
+
   private:
     /** @brief Text to display */
     std::string m_text;
     /** @brief Font to use */
     sdl::font m_font;
+    /** @brief Glyph atlas to use */
+    sdl::glyph_atlas m_glyph_atlas;
     /** @brief Text color */
     SDL_Color m_text_color;
+    /** @brief Scaling of the text size */
+    float m_text_scale;
+    /** @brief Length in pixel before wrapping the text */
+    Uint32 m_wrap_length;
+    /** @brief Scaling of the transformation applied when the text has been drawn with the glyph atlas */
+    float m_drawn_scaling;
+    /** @brief Size of the text drawn with the glyph atlas */
+    SDL_Rect m_text_size;
+
+    /** @brief Update the texture by rendering the text with the font */
+    void update_font_texture();
+    /** @brief Update the texture by drawing the text with the glyph atlas */
+    void update_glyph_texture();
+    /** @brief Get the scaling of the transformation to apply when drawing the text with the glyph atlas */
+    float get_glyph_scaling() const;
+    /** @brief Indicate if the glyphs can be drawn directly at each rendering instead of on the texture of the label */
+    bool can_draw_glyphs() const;
 };
 
 } // namespace widgets
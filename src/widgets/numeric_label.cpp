@@ -0,0 +1,274 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "numeric_label.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace widgets
+{
+
+/** @brief Constructor */
+numeric_label::numeric_label(sdl::renderer& renderer)
+    : widget(renderer),
+      m_value(0.),
+      m_precision(0),
+      m_min_chars(0),
+      m_unit(),
+      m_font(),
+      m_text_color{255, 255, 255, 0},
+      m_chars(),
+      m_char_count(0u),
+      m_glyphs(),
+      m_glyph_rects(),
+      m_space_width(0),
+      m_glyph_height(0),
+      m_target{nullptr, {0, 0, 0, 0}}
+{
+    m_char_count = format_value(m_chars);
+}
+
+/** @brief Set the value to display */
+void numeric_label::set_value(double value)
+{
+    m_value = value;
+
+    // The texture is only updated when the displayed characters change
+    std::array<char, MAX_CHARS> chars;
+    size_t                      count = format_value(chars);
+    if ((count != m_char_count) || (std::memcmp(chars.data(), m_chars.data(), count) != 0))
+    {
+        m_chars      = chars;
+        m_char_count = count;
+        update_needed();
+    }
+}
+
+/** @brief Set the number of digits after the dot */
+void numeric_label::set_precision(int precision)
+{
+    m_precision = std::max(precision, 0);
+    set_value(m_value);
+}
+
+/** @brief Set the minimum number of characters of the value, shorter values are padded with spaces on the left */
+void numeric_label::set_min_chars(int count)
+{
+    m_min_chars = std::min(std::max(count, 0), static_cast<int>(MAX_CHARS));
+    set_value(m_value);
+}
+
+/** @brief Set the unit displayed after the value */
+void numeric_label::set_unit(const std::string& unit)
+{
+    m_unit = unit;
+    render_glyphs();
+}
+
+/** @brief Set the font to use */
+void numeric_label::set_font(const sdl::font& font)
+{
+    m_font = font;
+    render_glyphs();
+}
+
+/** @brief Set the text color */
+void numeric_label::set_text_color(const SDL_Color& color)
+{
+    m_text_color = color;
+    render_glyphs();
+}
+
+/** @brief Update the texture representing the widget */
+void numeric_label::update_texture()
+{
+    // Compute text size
+    int width = 0;
+    for (size_t i = 0; i < m_char_count; i++)
+    {
+        int index = get_glyph_index(m_chars[i]);
+        width += ((index >= 0) ? m_glyph_rects[static_cast<size_t>(index)].w : m_space_width);
+    }
+    width += m_glyph_rects[GLYPH_COUNT].w;
+    SDL_Rect text_size = {0, 0, width, m_glyph_height};
+    if (m_is_autosized)
+    {
+        m_size = text_size;
+    }
+    m_position.w = m_size.w;
+    m_position.h = m_size.h;
+
+    if (m_glyphs && (m_size.w > 0) && (m_size.h > 0))
+    {
+        // Keep the target texture while the values fit in it
+        SDL_Rect target_size = (m_target.source ? m_target.source->get_size() : SDL_Rect{0, 0, 0, 0});
+        if ((m_target.rect.x + m_size.w <= target_size.w) && (m_target.rect.y + m_size.h <= target_size.h))
+        {
+            m_texture      = m_target.source;
+            m_texture_rect = {m_target.rect.x, m_target.rect.y, m_size.w, m_size.h};
+        }
+        else
+        {
+            m_target = {nullptr, {0, 0, 0, 0}};
+            if (create_target_texture(m_size.w, m_size.h))
+            {
+                m_target = {m_texture, m_texture_rect};
+            }
+        }
+
+        if (m_texture)
+        {
+            m_renderer->push_texture(m_texture);
+
+            // Fill background
+            m_renderer->set_draw_color(m_bg_color);
+            m_renderer->clear();
+
+            // Copy the glyphs of the value and of the unit
+            SDL_Rect dest = (m_is_autosized ? text_size : compute_alignment(text_size));
+            dest.x += m_texture_rect.x;
+            dest.y += m_texture_rect.y;
+            for (size_t i = 0; i <= m_char_count; i++)
+            {
+                int index = ((i < m_char_count) ? get_glyph_index(m_chars[i]) : static_cast<int>(GLYPH_COUNT));
+                if (index >= 0)
+                {
+                    const SDL_Rect& glyph_rect = m_glyph_rects[static_cast<size_t>(index)];
+                    SDL_Rect        glyph_dest = {dest.x, dest.y, glyph_rect.w, glyph_rect.h};
+                    if (glyph_rect.w > 0)
+                    {
+                        m_renderer->copy(m_glyphs, &glyph_rect, &glyph_dest);
+                    }
+                    dest.x += glyph_rect.w;
+                }
+                else
+                {
+                    dest.x += m_space_width;
+                }
+            }
+
+            // Restore renderer state
+            m_renderer->pop_texture();
+        }
+    }
+    else
+    {
+        m_texture = nullptr;
+    }
+}
+
+/** @brief Format the value */
+size_t numeric_label::format_value(std::array<char, MAX_CHARS>& chars) const
+{
+    size_t count  = 0u;
+    auto   result = std::to_chars(chars.data(), chars.data() + chars.size(), m_value, std::chars_format::fixed, m_precision);
+    if (result.ec == std::errc())
+    {
+        count = static_cast<size_t>(result.ptr - chars.data());
+    }
+
+    // Pad with spaces on the left
+    size_t min_chars = static_cast<size_t>(m_min_chars);
+    if (count < min_chars)
+    {
+        std::copy_backward(chars.data(), chars.data() + count, chars.data() + min_chars);
+        std::fill(chars.data(), chars.data() + (min_chars - count), ' ');
+        count = min_chars;
+    }
+    return count;
+}
+
+/** @brief Render the glyphs of the characters and of the unit */
+void numeric_label::render_glyphs()
+{
+    m_glyphs = nullptr;
+    m_glyph_rects.fill(SDL_Rect{0, 0, 0, 0});
+    m_space_width  = 0;
+    m_glyph_height = 0;
+    if (m_font)
+    {
+        // Render each character and the unit
+        std::array<sdl::surface, GLYPH_COUNT + 1u> images;
+        int                                        width = 0;
+        for (size_t i = 0; i < images.size(); i++)
+        {
+            std::string text = ((i < GLYPH_COUNT) ? std::string(1u, CHARSET[i]) : m_unit);
+            if (!text.empty())
+            {
+                images[i] = m_font->render_blended(text, m_text_color);
+            }
+            if (images[i])
+            {
+                SDL_Rect size    = images[i]->get_size();
+                m_glyph_rects[i] = {width, 0, size.w, size.h};
+                width += size.w;
+                m_glyph_height = std::max(m_glyph_height, size.h);
+            }
+        }
+        m_space_width  = m_font->get_advance(' ');
+        m_glyph_height = std::max(m_glyph_height, m_font->get_height());
+
+        // Pack them side by side into a single texture
+        sdl::surface strip;
+        if (width > 0)
+        {
+            strip = sdl::create_surface(width, m_glyph_height, 32, SDL_PIXELFORMAT_ARGB8888);
+        }
+        if (strip)
+        {
+            for (size_t i = 0; i < images.size(); i++)
+            {
+                if (images[i])
+                {
+                    SDL_Rect dest = m_glyph_rects[i];
+                    images[i]->set_blend_mod(SDL_BLENDMODE_NONE);
+                    strip->blit(images[i], nullptr, &dest);
+                }
+            }
+            m_glyphs = m_renderer->create_texture(strip);
+            if (m_glyphs)
+            {
+                m_glyphs->set_blend_mode(SDL_BLENDMODE_BLEND);
+            }
+        }
+    }
+    update_needed();
+}
+
+/** @brief Get the index of the glyph of a character */
+int numeric_label::get_glyph_index(char c)
+{
+    int index = -1;
+    if ((c >= '0') && (c <= '9'))
+    {
+        index = c - '0';
+    }
+    else if (c == '-')
+    {
+        index = 10;
+    }
+    else if (c == '.')
+    {
+        index = 11;
+    }
+    return index;
+}
+
+} // namespace widgets
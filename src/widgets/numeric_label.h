@@ -0,0 +1,129 @@
+/*
+Copyright (c) 2023 Cedric Jimenez
+This file is part of SDLHelper.
+
+SDLHelper is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 2.1 of the License, or
+(at your option) any later version.
+
+SDLHelper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAME_NUMERIC_LABEL_H
+#define GAME_NUMERIC_LABEL_H
+
+#include <array>
+#include <string>
+
+#include "sdl_font.h"
+#include "widget.h"
+
+namespace widgets
+{
+
+/** @brief Label widget to display a frequently changing number (ex: score, timer, framerate)
+ *         The glyphs of the digits, sign, dot and unit are rendered once into a texture,
+ *         a new value is displayed by copying its glyphs without any rasterization nor upload */
+class numeric_label : public widget
+{
+  public:
+    /** @brief Constructor */
+    numeric_label(sdl::renderer& renderer);
+    /** @brief Destructor */
+    virtual ~numeric_label() = default;
+
+    /** @brief Copy constructor => deleted */
+    numeric_label(const numeric_label& copy) = delete;
+    /** @brief Copy assignment => deleted */
+    numeric_label& operator=(const numeric_label& copy) = delete;
+
+    /** @brief Set the value to display */
+    void set_value(double value);
+    /** @brief Get the displayed value */
+    double get_value() const { return m_value; }
+
+    /** @brief Set the number of digits after the dot */
+    void set_precision(int precision);
+    /** @brief Get the number of digits after the dot */
+    int get_precision() const { return m_precision; }
+
+    /** @brief Set the minimum number of characters of the value, shorter values are padded with spaces on the left */
+    void set_min_chars(int count);
+    /** @brief Get the minimum number of characters of the value */
+    int get_min_chars() const { return m_min_chars; }
+
+    /** @brief Set the unit displayed after the value (ex: " FPS") */
+    void set_unit(const std::string& unit);
+    /** @brief Get the unit displayed after the value */
+    const std::string& get_unit() const { return m_unit; }
+
+    /** @brief Set the font to use */
+    void set_font(const sdl::font& font);
+    /** @brief Get the font to use */
+    sdl::font get_font() const { return m_font; }
+
+    /** @brief Set the text color */
+    void set_text_color(const SDL_Color& color);
+    /** @brief Get the text color */
+    SDL_Color get_text_color() const { return m_text_color; }
+
+    /** @brief Update the texture representing the widget */
+    void update_texture() override;
+
+  private:
+    /** @brief Characters which can be displayed */
+    static constexpr const char* CHARSET = "0123456789-.";
+    /** @brief Number of characters which can be displayed */
+    static constexpr size_t GLYPH_COUNT = 12u;
+    /** @brief Maximum number of characters of a formatted value */
+    static constexpr size_t MAX_CHARS = 64u;
+
+    /** @brief Value to display */
+    double m_value;
+    /** @brief Number of digits after the dot */
+    int m_precision;
+    /** @brief Minimum number of characters of the value */
+    int m_min_chars;
+    /** @brief Unit displayed after the value */
+    std::string m_unit;
+    /** @brief Font to use */
+    sdl::font m_font;
+    /** @brief Text color */
+    SDL_Color m_text_color;
+    /** @brief Formatted value */
+    std::array<char, MAX_CHARS> m_chars;
+    /** @brief Number of characters of the formatted value */
+    size_t m_char_count;
+    /** @brief Texture containing the glyphs of the characters followed by the unit */
+    sdl::texture m_glyphs;
+    /** @brief Area of each glyph in the glyph texture, the last one is the unit */
+    std::array<SDL_Rect, GLYPH_COUNT + 1u> m_glyph_rects;
+    /** @brief Width of a space */
+    int m_space_width;
+    /** @brief Height of the glyphs */
+    int m_glyph_height;
+    /** @brief Target texture kept between the values */
+    sdl::texture_region m_target;
+
+    /**
+     * @brief Format the value
+     * @param chars Formatted value
+     * @return Number of characters of the formatted value
+     */
+    size_t format_value(std::array<char, MAX_CHARS>& chars) const;
+    /** @brief Render the glyphs of the characters and of the unit */
+    void render_glyphs();
+    /** @brief Get the index of the glyph of a character (-1 if the character has no glyph) */
+    static int get_glyph_index(char c);
+};
+
+} // namespace widgets
+
+#endif // GAME_NUMERIC_LABEL_H
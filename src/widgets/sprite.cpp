@@ -23,9 +23,18 @@ namespace widgets
 
 /** @brief Constructor */
 sprite::sprite(sdl::renderer& renderer)
-    : widget(renderer), m_fps(), m_fps_period(), m_next_image_ts(), m_animations(), m_current_anim(nullptr)
+    : widget(renderer),
+      m_fps(),
+      m_fps_period(),
+      m_next_image_ts(),
+      m_animations(),
+      m_current_anim(nullptr),
+      m_current_img(),
+      m_image(renderer),
+      m_image_source(nullptr)
 {
     set_framerate(30.f);
+    set_direct_draw(true);
 }
 
 /** @brief Add an animation */
@@ -48,16 +57,8 @@ bool sprite::add_img_animation(int id, const image_list& animation)
     auto iter_anim = m_animations.find(id);
     if (iter_anim == m_animations.end())
     {
-        // Copy the image list
-        image_list anim;
-        for (auto& img : animation)
-        {
-            auto part = std::make_unique<image>(*img.second);
-            anim.emplace_back(img.first, std::move(part));
-        }
-
-        // Save animation
-        m_animations[id] = std::move(anim);
+        // Share the images of the animation
+        m_animations[id] = animation;
 
         // Update rendering
         update_needed();
@@ -95,6 +96,9 @@ bool sprite::set_img_animation(int id)
         m_current_anim = &iter_anim->second;
         m_current_img  = m_current_anim->begin();
 
+        // Display the first image at next rendering
+        update_needed();
+
         ret = true;
     }
 
@@ -104,24 +108,8 @@ bool sprite::set_img_animation(int id)
 /** @brief Update the texture representing the widget */
 void sprite::update_texture()
 {
-    // For each animation
-    for (auto& animation : m_animations)
-    {
-        // For each image
-        for (auto& [id, image] : animation.second)
-        {
-            // Apply settings
-            image->set_background_color(get_background_color());
-            image->set_size(get_size());
-            image->set_autosize(get_autosize());
-            image->set_halign(get_halign());
-            image->set_valign(get_valign());
-            image->set_adjust(get_adjust());
-
-            // Update texture
-            image->update_texture();
-        }
-    }
+    // Take into account the new settings for the current image
+    show_current_image();
 }
 
 /** @brief Called to notify that the rendering process starts */
@@ -141,13 +129,7 @@ void sprite::on_render()
             }
 
             // Get corresponding texture
-            m_texture = m_current_img->second->get_texture();
-            if (m_texture)
-            {
-                SDL_Rect size = m_texture->get_size();
-                m_position.w  = size.w;
-                m_position.h  = size.h;
-            }
+            show_current_image();
 
             // Next image timestamp
             m_next_image_ts = now + m_fps_period;
@@ -155,4 +137,41 @@ void sprite::on_render()
     }
 }
 
+/** @brief Display the current image */
+void sprite::show_current_image()
+{
+    if (m_current_anim && (m_current_img != m_current_anim->end()))
+    {
+        // The image of the sprite only references the source region of the shared image
+        const image& shared = *m_current_img->second;
+        if (&shared != m_image_source)
+        {
+            m_image        = shared;
+            m_image_source = &shared;
+        }
+
+        // Apply settings, the texture of the image is only updated if they or the displayed image have changed
+        m_image.set_background_color(get_background_color());
+        m_image.set_size(get_size());
+        m_image.set_autosize(get_autosize());
+        m_image.set_halign(get_halign());
+        m_image.set_valign(get_valign());
+        m_image.set_adjust(get_adjust());
+        m_image.set_direct_draw(can_draw_direct());
+        m_image.refresh();
+
+        m_texture         = m_image.get_texture();
+        m_is_drawn_direct = m_image.is_drawn_direct();
+        if (m_texture)
+        {
+            const SDL_Rect* rect = m_image.get_texture_rect();
+            SDL_Rect        size = m_image.get_size_position();
+            m_position.w         = size.w;
+            m_position.h         = size.h;
+            m_texture_area       = m_image.get_texture_area();
+            m_texture_rect       = (rect ? *rect : SDL_Rect{0, 0, 0, 0});
+        }
+    }
+}
+
 } // namespace widgets
@@ -21,6 +21,7 @@ along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
 
 #include <chrono>
 #include <list>
+#include <memory>
 #include <unordered_map>
 
 #include "image.h"
@@ -28,12 +29,17 @@ along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
 namespace widgets
 {
 
-/** @brief Image composing an animation */
-using image_anim = std::pair<unsigned int, std::unique_ptr<image>>;
+/** @brief Image composing an animation, shared between all the sprites displaying the animation */
+using image_anim = std::pair<unsigned int, std::shared_ptr<image>>;
 /** @brief List of images composing an animation */
 using image_list = std::list<image_anim>;
 
-/** @brief Sprite widget to display animated images */
+/** @brief Sprite widget to display animated images
+ *         The images of the animations are shared with the other sprites using the same animations and are never
+ *         modified, each sprite displays the current one through a single image of its own holding its settings
+ *         (size, background...) which is pointed at the region of the current shared image on each image change.
+ *         Direct drawing is enabled by default so that the images are drawn from their texture atlas
+ *         and consecutive sprites sharing an atlas are batched in a single geometry call */
 class sprite : public widget
 {
   public:
@@ -47,9 +53,9 @@ class sprite : public widget
     /** @brief Copy assignment => deleted */
     sprite& operator=(const sprite& copy) = delete;
 
-    /** @brief Add an animation */
+    /** @brief Add an animation (the images are shared, not copied) */
     bool add_img_animation(int id, const image_list* animation);
-    /** @brief Add an animation */
+    /** @brief Add an animation (the images are shared, not copied) */
     bool add_img_animation(int id, const image_list& animation);
 
     /** @brief Set the current animation */
@@ -80,6 +86,13 @@ class sprite : public widget
     image_list* m_current_anim;
     /** @brief Current image in the current animation */
     image_list::iterator m_current_img;
+    /** @brief Image of the sprite displaying the current shared image with the settings of the sprite */
+    image m_image;
+    /** @brief Shared image displayed by the image of the sprite */
+    const image* m_image_source;
+
+    /** @brief Display the current image */
+    void show_current_image();
 };
 
 } // namespace widgets
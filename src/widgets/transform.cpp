@@ -114,13 +114,65 @@ bool transform::apply(sdl::renderer& renderer, widget& w)
 {
     bool ret = false;
 
+    // Fill the background of the widgets drawn without intermediate texture
+    SDL_Rect  box      = w.get_size_position();
+    SDL_Color bg_color = w.get_background_color();
+    if (w.is_drawn_direct() && (bg_color.a != 0))
+    {
+        SDL_Rect background = {box.x,
+                               box.y,
+                               static_cast<int>(static_cast<float>(box.w) * m_scaling),
+                               static_cast<int>(static_cast<float>(box.h) * m_scaling)};
+
+        // Restore the drawing state of the renderer once the background is filled
+        SDL_BlendMode blend_mode = renderer->get_blend_mode();
+        SDL_Color     draw_color = renderer->get_draw_color();
+        renderer->set_blend_mode(SDL_BLENDMODE_BLEND);
+        renderer->set_draw_color(bg_color);
+        renderer->fill_rect(background);
+        renderer->set_draw_color(draw_color);
+        renderer->set_blend_mode(blend_mode);
+    }
+
+    // Mirror the area covered by the texture when flipping so that it stays at the same place in the widget
+    SDL_Rect area = w.get_texture_area();
+    if ((m_flip & SDL_FLIP_HORIZONTAL) != 0)
+    {
+        area.x = box.w - area.x - area.w;
+    }
+    if ((m_flip & SDL_FLIP_VERTICAL) != 0)
+    {
+        area.y = box.h - area.y - area.h;
+    }
+
     // Compute new size
-    SDL_Rect size = w.get_size_position();
-    size.w        = static_cast<int>(static_cast<float>(size.w) * m_scaling);
-    size.h        = static_cast<int>(static_cast<float>(size.h) * m_scaling);
+    SDL_Rect size;
+    size.x = box.x + static_cast<int>(static_cast<float>(area.x) * m_scaling);
+    size.y = box.y + static_cast<int>(static_cast<float>(area.y) * m_scaling);
+    size.w = static_cast<int>(static_cast<float>(area.w) * m_scaling);
+    size.h = static_cast<int>(static_cast<float>(area.h) * m_scaling);
+
+    // Rotate around the center of the widget, not around the center of the area covered by the texture
+    const SDL_Point* rot_center = m_rot_center_ptr;
+    SDL_Point        center;
+    if ((area.w != box.w) || (area.h != box.h))
+    {
+        if (m_rot_center_ptr)
+        {
+            center = m_rot_center;
+        }
+        else
+        {
+            center.x = static_cast<int>(static_cast<float>(box.w) * m_scaling) / 2;
+            center.y = static_cast<int>(static_cast<float>(box.h) * m_scaling) / 2;
+        }
+        center.x -= size.x - box.x;
+        center.y -= size.y - box.y;
+        rot_center = &center;
+    }
 
-    // Render widget
-    ret = renderer->copy(w.get_texture(), nullptr, &size, m_rot_angle, m_rot_center_ptr, m_flip);
+    // Render widget, the widgets drawing their contents without texture only need their background
+    ret = (!w.get_texture() || renderer->copy(w.get_texture(), w.get_texture_rect(), &size, m_rot_angle, rot_center, m_flip));
 
     return ret;
 }
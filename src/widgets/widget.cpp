@@ -18,6 +18,8 @@ along with SDLHelper. If not, see <http://www.gnu.org/licenses/>.
 
 #include "widget.h"
 
+#include <algorithm>
+
 namespace widgets
 {
 
@@ -28,6 +30,7 @@ widget::widget(sdl::renderer& renderer)
       m_is_visible(true),
       m_animation(),
       m_transform(),
+      m_layer(0),
       m_draw_boundary_box(false),
       m_bg_color{0, 0, 0, 0},
       m_is_autosized(true),
@@ -37,6 +40,11 @@ widget::widget(sdl::renderer& renderer)
       m_valign(valign::center),
       m_adjust(adjust::fit),
       m_texture(),
+      m_texture_area{0, 0, 0, 0},
+      m_texture_rect{0, 0, 0, 0},
+      m_is_direct_draw(false),
+      m_is_drawn_direct(false),
+      m_is_contents_drawn(false),
       m_is_update_needed(true)
 {
 }
@@ -54,8 +62,11 @@ widget::~widget()
 /** @brief Set the background color */
 void widget::set_background_color(const SDL_Color& color)
 {
-    m_bg_color = color;
-    update_needed();
+    if ((color.r != m_bg_color.r) || (color.g != m_bg_color.g) || (color.b != m_bg_color.b) || (color.a != m_bg_color.a))
+    {
+        m_bg_color = color;
+        update_needed();
+    }
 }
 
 /** @brief Set the position */
@@ -68,8 +79,11 @@ void widget::set_position(const SDL_Point& pos)
 /** @brief Set the size */
 void widget::set_size(const SDL_Rect& size)
 {
-    m_size = size;
-    update_needed();
+    if ((size.x != m_size.x) || (size.y != m_size.y) || (size.w != m_size.w) || (size.h != m_size.h))
+    {
+        m_size = size;
+        update_needed();
+    }
 }
 /** @brief Set the size and position */
 void widget::set_size_position(const SDL_Rect& size_position)
@@ -83,29 +97,51 @@ void widget::set_size_position(const SDL_Rect& size_position)
 /** @brief Set the auto size capability */
 void widget::set_autosize(bool is_autosized)
 {
-    m_is_autosized = is_autosized;
-    update_needed();
+    if (is_autosized != m_is_autosized)
+    {
+        m_is_autosized = is_autosized;
+        update_needed();
+    }
 }
 
 /** @brief Set the horizontal alignment of the text of the widget */
 void widget::set_halign(halign align)
 {
-    m_halign = align;
-    update_needed();
+    if (align != m_halign)
+    {
+        m_halign = align;
+        update_needed();
+    }
 }
 
 /** @brief Set the vertical alignment of the text of the widget */
 void widget::set_valign(valign align)
 {
-    m_valign = align;
-    update_needed();
+    if (align != m_valign)
+    {
+        m_valign = align;
+        update_needed();
+    }
 }
 
 /** @brief Set the adjustment of the contents */
 void widget::set_adjust(adjust adj)
 {
-    m_adjust = adj;
-    update_needed();
+    if (adj != m_adjust)
+    {
+        m_adjust = adj;
+        update_needed();
+    }
+}
+
+/** @brief Enable/disable the drawing of the contents directly from their source texture without intermediate texture */
+void widget::set_direct_draw(bool is_enabled)
+{
+    if (is_enabled != m_is_direct_draw)
+    {
+        m_is_direct_draw = is_enabled;
+        update_needed();
+    }
 }
 
 /** @brief Render the widget */
@@ -114,29 +150,70 @@ void widget::render()
     // Notify widget that rendering process starts
     on_render();
 
+    // Select the layer for the deferred draw operations
+    m_renderer->set_layer(m_layer);
+
+    // Apply animation
+    m_animation.apply(*this);
+    on_refresh();
+
     // Check if the texture must be updated
-    if (m_is_update_needed)
+    // (the background of contents drawn directly cannot be rotated, an intermediate texture is needed)
+    if (m_is_drawn_direct && !can_draw_direct())
     {
-        // Widget specific implementation
-        update_texture();
-        m_is_update_needed = false;
+        update_needed();
     }
+    refresh();
 
-    // Render widget's texture
-    if (m_texture)
+    // Render widget's texture, or its contents drawn without texture
+    if (m_texture || m_is_contents_drawn)
     {
         // Draw boundary box
-        if (m_draw_boundary_box)
+        if (m_draw_boundary_box && !m_is_drawn_direct)
         {
+            const SDL_Rect* rect = get_texture_rect();
             m_renderer->set_draw_color(SDL_Color{0, 255, 0, 255});
             m_renderer->push_texture(m_texture);
-            m_renderer->draw_rect(m_texture->get_size());
+            m_renderer->draw_rect(rect ? *rect : m_texture->get_size());
             m_renderer->pop_texture();
         }
 
         // Render with transformation
-        m_animation.apply(*this);
         m_transform.apply(m_renderer, *this);
+        if (m_is_contents_drawn)
+        {
+            draw_contents();
+        }
+
+        // Draw boundary box over the widget since the source texture must not be modified
+        if (m_draw_boundary_box && m_is_drawn_direct)
+        {
+            float    scaling = m_transform.get_scaling();
+            SDL_Rect box     = {m_position.x,
+                                m_position.y,
+                                static_cast<int>(static_cast<float>(m_position.w) * scaling),
+                                static_cast<int>(static_cast<float>(m_position.h) * scaling)};
+            m_renderer->set_draw_color(SDL_Color{0, 255, 0, 255});
+            m_renderer->draw_rect(box);
+        }
+    }
+}
+
+/** @brief Update the texture representing the widget if needed */
+void widget::refresh()
+{
+    if (m_is_update_needed)
+    {
+        // By default the texture covers the whole widget
+        m_texture_area      = {0, 0, 0, 0};
+        m_texture_rect      = {0, 0, 0, 0};
+        m_is_drawn_direct   = false;
+        m_is_contents_drawn = false;
+
+        // Widget specific implementation
+        sdl::sdl_profiler::zone zone(m_renderer->get_profiler(), "update_texture");
+        update_texture();
+        m_is_update_needed = false;
     }
 }
 
@@ -147,6 +224,17 @@ void widget::update_needed()
     m_is_update_needed = true;
 }
 
+/** @brief Get the area of the widget covered by its texture (relative to the widget position, unscaled) */
+SDL_Rect widget::get_texture_area() const
+{
+    SDL_Rect area = m_texture_area;
+    if ((area.w <= 0) || (area.h <= 0))
+    {
+        area = {0, 0, m_position.w, m_position.h};
+    }
+    return area;
+}
+
 /** @brief Compute the position of a content based on its alignment */
 SDL_Rect widget::compute_alignment(const SDL_Rect& content_size)
 {
@@ -180,4 +268,63 @@ SDL_Rect widget::compute_alignment(const SDL_Rect& content_size)
     return position;
 }
 
+/** @brief Get the intermediate texture of the widget from the texture pool of the renderer */
+bool widget::create_target_texture(int w, int h)
+{
+    // Give back the previous texture so that it can be reused
+    m_texture = nullptr;
+
+    sdl::texture_region target;
+    bool                ret = m_renderer->get_texture_pool()->acquire(SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, w, h, target);
+    if (ret)
+    {
+        m_texture      = target.source;
+        m_texture_rect = target.rect;
+        m_texture->set_blend_mode(SDL_BLENDMODE_BLEND);
+    }
+    return ret;
+}
+
+/** @brief Indicate if the contents can be drawn directly with the current background and transformation */
+bool widget::can_draw_direct() const
+{
+    return (m_is_direct_draw && ((m_bg_color.a == 0) || (m_transform.get_rot_angle() == 0.)));
+}
+
+/** @brief Draw the contents directly from their source texture */
+void widget::set_direct_texture(const sdl::texture& source, const SDL_Rect& src_rect, const SDL_Rect& dest)
+{
+    // Clip the contents to the widget
+    int left   = std::max(dest.x, 0);
+    int top    = std::max(dest.y, 0);
+    int right  = std::min(dest.x + dest.w, m_position.w);
+    int bottom = std::min(dest.y + dest.h, m_position.h);
+    if ((right > left) && (bottom > top) && (dest.w > 0) && (dest.h > 0))
+    {
+        // Clip the source area accordingly
+        float scale_x    = static_cast<float>(src_rect.w) / static_cast<float>(dest.w);
+        float scale_y    = static_cast<float>(src_rect.h) / static_cast<float>(dest.h);
+        m_texture_rect.x = src_rect.x + static_cast<int>(static_cast<float>(left - dest.x) * scale_x);
+        m_texture_rect.y = src_rect.y + static_cast<int>(static_cast<float>(top - dest.y) * scale_y);
+        m_texture_rect.w = static_cast<int>(static_cast<float>(right - left) * scale_x);
+        m_texture_rect.h = static_cast<int>(static_cast<float>(bottom - top) * scale_y);
+        m_texture_area   = {left, top, right - left, bottom - top};
+        m_texture        = source;
+    }
+    else
+    {
+        // Nothing to draw
+        m_texture = nullptr;
+    }
+    m_is_drawn_direct = true;
+}
+
+/** @brief Draw the contents directly over the background at each rendering with draw_contents(), without texture */
+void widget::set_direct_contents()
+{
+    m_texture           = nullptr;
+    m_is_drawn_direct   = true;
+    m_is_contents_drawn = true;
+}
+
 } // namespace widgets
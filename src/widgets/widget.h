@@ -90,6 +90,11 @@ class widget
     /** @brief Get the geometrical transformation applied to the widget */
     const transform& get_transform() const { return m_transform; }
 
+    /** @brief Set the layer of the widget used to order the draw operations in deferred rendering mode */
+    void set_layer(int layer) { m_layer = layer; }
+    /** @brief Get the layer of the widget */
+    int get_layer() const { return m_layer; }
+
     /** @brief Enable/disable the display of the boundary box */
     void set_boundary_box(bool is_enabled) { m_draw_boundary_box = is_enabled; }
 
@@ -133,8 +138,16 @@ class widget
     /** @brief Get the adjustment of the contents */
     adjust get_adjust() const { return m_adjust; }
 
+    /** @brief Enable/disable the drawing of the contents directly from their source texture without intermediate texture
+     *         (only used when the background is transparent or when the widget is not rotated) */
+    void set_direct_draw(bool is_enabled);
+    /** @brief Get the direct drawing of the contents */
+    bool get_direct_draw() const { return m_is_direct_draw; }
+
     /** @brief Render the widget */
     void render();
+    /** @brief Update the texture representing the widget if needed (without rendering it) */
+    void refresh();
     /** @brief Indicate that the widget texture must be updated for next rendering */
     void update_needed();
 
@@ -142,6 +155,12 @@ class widget
     virtual void update_texture() = 0;
     /** @brief Get the texture representing the widget */
     sdl::texture& get_texture() { return m_texture; }
+    /** @brief Get the area of the widget covered by its texture (relative to the widget position, unscaled) */
+    SDL_Rect get_texture_area() const;
+    /** @brief Get the area of the texture to draw (nullptr for the whole texture) */
+    const SDL_Rect* get_texture_rect() const { return ((m_texture_rect.w > 0) ? &m_texture_rect : nullptr); }
+    /** @brief Indicate if the texture is the source texture of the contents drawn directly over the background */
+    bool is_drawn_direct() const { return m_is_drawn_direct; }
 
   protected:
     /** @brief Renderer of the widget */
@@ -154,6 +173,8 @@ class widget
     animation m_animation;
     /** @brief Transformation */
     transform m_transform;
+    /** @brief Layer of the widget */
+    int m_layer;
     /** @brief Indicate if a boundary box must be displayed around the widget */
     bool m_draw_boundary_box;
     /** @brief Background color */
@@ -172,13 +193,42 @@ class widget
     adjust m_adjust;
     /** @brief Texture representing the widget */
     sdl::texture m_texture;
+    /** @brief Area of the widget covered by its texture (empty if the texture covers the whole widget) */
+    SDL_Rect m_texture_area;
+    /** @brief Area of the texture to draw (empty for the whole texture) */
+    SDL_Rect m_texture_rect;
+    /** @brief Indicate if the direct drawing of the contents is enabled */
+    bool m_is_direct_draw;
+    /** @brief Indicate if the texture is the source texture of the contents drawn directly over the background */
+    bool m_is_drawn_direct;
+    /** @brief Indicate if the contents are drawn directly over the background by draw_contents() instead of from a texture */
+    bool m_is_contents_drawn;
 
     /** @brief Called to notify that the rendering process starts */
     virtual void on_render() { }
+    /** @brief Called once the animation has been applied, before the texture is updated if needed */
+    virtual void on_refresh() { }
+    /** @brief Draw the contents directly over the background at each rendering (see set_direct_contents()) */
+    virtual void draw_contents() { }
 
     /** @brief Compute the position of a content based on its alignment */
     SDL_Rect compute_alignment(const SDL_Rect& content_size);
 
+    /** @brief Get the intermediate texture of the widget from the texture pool of the renderer */
+    bool create_target_texture(int w, int h);
+
+    /** @brief Indicate if the contents can be drawn directly with the current background and transformation */
+    bool can_draw_direct() const;
+    /**
+     * @brief Draw the contents directly from their source texture
+     * @param source Source texture of the contents
+     * @param src_rect Area of the source texture containing the contents
+     * @param dest Position and size of the contents in the widget, the parts outside of the widget are clipped
+     */
+    void set_direct_texture(const sdl::texture& source, const SDL_Rect& src_rect, const SDL_Rect& dest);
+    /** @brief Draw the contents directly over the background at each rendering with draw_contents(), without texture */
+    void set_direct_contents();
+
   private:
     /** @brief Indicate if the widget texture must be updated for next rendering */
     bool m_is_update_needed;
@@ -0,0 +1,356 @@
+/*
+MIT License
+
+Copyright (c) 2023 Cedric Jimenez
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "sdl.h"
+#include "sdl_font.h"
+#include "sdl_surface.h"
+
+using namespace std;
+
+/** @brief Size of the pages of the generated fonts */
+static constexpr int PAGE_SIZE = 512;
+/** @brief Empty space kept around each glyph to avoid bleeding when filtering */
+static constexpr int PADDING = 1;
+
+/** @brief Glyph packed into a page */
+struct cooked_glyph
+{
+    /** @brief Unicode code point */
+    Uint32 ch;
+    /** @brief Index of the page containing the glyph */
+    int page;
+    /** @brief Position and size of the glyph in its page */
+    SDL_Rect rect;
+    /** @brief Horizontal offset of the glyph from the pen position */
+    int offset_x;
+    /** @brief Vertical offset of the glyph from the top of the line */
+    int offset_y;
+    /** @brief Horizontal advance of the pen */
+    int advance;
+};
+
+/** @brief Kerning between 2 glyphs */
+struct cooked_kerning
+{
+    /** @brief Unicode code point of the first glyph */
+    Uint32 first;
+    /** @brief Unicode code point of the second glyph */
+    Uint32 second;
+    /** @brief Horizontal adjustment of the pen between the glyphs */
+    int amount;
+};
+
+/** @brief Code points stored in the generated fonts : printable ASCII and Latin-1 characters */
+static vector<Uint32> get_charset()
+{
+    vector<Uint32> charset;
+    for (Uint32 ch = 32u; ch < 127u; ch++)
+    {
+        charset.push_back(ch);
+    }
+    for (Uint32 ch = 160u; ch < 256u; ch++)
+    {
+        charset.push_back(ch);
+    }
+    return charset;
+}
+
+/** @brief Look for the font files to convert */
+static vector<filesystem::path> find_fonts(const filesystem::path& input)
+{
+    vector<filesystem::path> fonts;
+    if (filesystem::is_directory(input))
+    {
+        for (const auto& dir_entry : filesystem::directory_iterator(input))
+        {
+            string ext = dir_entry.path().extension().string();
+            if (dir_entry.is_regular_file() && ((ext == ".woff") || (ext == ".ttf") || (ext == ".otf")))
+            {
+                fonts.push_back(dir_entry.path());
+            }
+        }
+        sort(fonts.begin(), fonts.end());
+    }
+    else
+    {
+        fonts.push_back(input);
+    }
+    return fonts;
+}
+
+/** @brief Compute the smallest area containing all the non transparent pixels of an ARGB8888 glyph image */
+static SDL_Rect get_opaque_bounds(const sdl::surface& image)
+{
+    SDL_Rect size   = image->get_size();
+    SDL_Rect bounds = {size.w, size.h, 0, 0};
+    int      max_x  = -1;
+    int      max_y  = -1;
+    for (int y = 0; y < size.h; y++)
+    {
+        const Uint32* row = reinterpret_cast<const Uint32*>(static_cast<const Uint8*>(image->get_pixels()) + y * image->get_pitch());
+        for (int x = 0; x < size.w; x++)
+        {
+            if ((row[x] & 0xFF000000u) != 0u)
+            {
+                bounds.x = min(bounds.x, x);
+                bounds.y = min(bounds.y, y);
+                max_x    = max(max_x, x);
+                max_y    = max(max_y, y);
+            }
+        }
+    }
+    if (max_x >= 0)
+    {
+        bounds.w = max_x - bounds.x + 1;
+        bounds.h = max_y - bounds.y + 1;
+    }
+    else
+    {
+        bounds = {0, 0, 0, 0};
+    }
+    return bounds;
+}
+
+/** @brief Pack the glyphs of a font into pages using shelves */
+static bool cook_glyphs(const sdl::font& font, vector<sdl::surface>& pages, vector<cooked_glyph>& glyphs)
+{
+    bool         ret     = true;
+    const Uint32 format  = SDL_PIXELFORMAT_ARGB8888;
+    int          shelf_x = 0;
+    int          shelf_y = 0;
+    int          shelf_h = 0;
+    SDL_Color    white   = {255, 255, 255, 255};
+    auto         new_page = [&]()
+    {
+        pages.push_back(sdl::create_surface(PAGE_SIZE, PAGE_SIZE, 32, format));
+        shelf_x = 0;
+        shelf_y = 0;
+        shelf_h = 0;
+        return (pages.back() != nullptr);
+    };
+
+    for (Uint32 ch : get_charset())
+    {
+        int minx    = 0;
+        int maxx    = 0;
+        int miny    = 0;
+        int maxy    = 0;
+        int advance = 0;
+        if (!font->get_glyph_metrics(ch, minx, maxx, miny, maxy, advance))
+        {
+            // Not available in the font
+            continue;
+        }
+
+        // Glyphs without pixels (ex: space) only have an advance
+        cooked_glyph glyph  = {ch, 0, {0, 0, 0, 0}, 0, 0, advance};
+        sdl::surface image;
+        SDL_Rect     bounds = {0, 0, 0, 0};
+        if ((maxx > minx) && (maxy > miny))
+        {
+            // The rendered glyph is as high as the line, only its opaque area is stored
+            image = font->render_glyph_blended(ch, white);
+            if (image)
+            {
+                image = image->convert(format);
+            }
+            if (!image)
+            {
+                ret = false;
+                break;
+            }
+            bounds = get_opaque_bounds(image);
+        }
+        if ((bounds.w > 0) && (bounds.h > 0))
+        {
+            glyph.offset_x = min(minx, 0) + bounds.x;
+            glyph.offset_y = bounds.y;
+
+            // Place the glyph on the current shelf, or on a new one
+            if (pages.empty() || ((shelf_x + bounds.w + PADDING) > PAGE_SIZE))
+            {
+                shelf_x = 0;
+                shelf_y = shelf_y + shelf_h;
+                shelf_h = 0;
+            }
+            if (pages.empty() || ((shelf_y + bounds.h + PADDING) > PAGE_SIZE))
+            {
+                if (!new_page())
+                {
+                    ret = false;
+                    break;
+                }
+            }
+            glyph.page = static_cast<int>(pages.size()) - 1;
+            glyph.rect = {shelf_x, shelf_y, bounds.w, bounds.h};
+            shelf_x += bounds.w + PADDING;
+            shelf_h = max(shelf_h, bounds.h + PADDING);
+
+            // Copy the pixels including their alpha
+            SDL_Rect dest = glyph.rect;
+            image->set_blend_mod(SDL_BLENDMODE_NONE);
+            ret = pages.back()->blit(image, &bounds, &dest);
+            if (!ret)
+            {
+                break;
+            }
+        }
+        glyphs.push_back(glyph);
+    }
+    return ret;
+}
+
+/** @brief Compute the kernings between all the glyphs of a font */
+static vector<cooked_kerning> cook_kernings(const sdl::font& font, const vector<cooked_glyph>& glyphs)
+{
+    vector<cooked_kerning> kernings;
+    for (const auto& first : glyphs)
+    {
+        for (const auto& second : glyphs)
+        {
+            int amount = font->get_kerning(first.ch, second.ch);
+            if (amount != 0)
+            {
+                kernings.push_back({first.ch, second.ch, amount});
+            }
+        }
+    }
+    return kernings;
+}
+
+/** @brief Write the description of a font in the BMFont text format */
+static bool write_description(const filesystem::path&       path,
+                              const string&                 face,
+                              int                           ptsize,
+                              int                           line_height,
+                              const vector<string>&         page_files,
+                              const vector<cooked_glyph>&   glyphs,
+                              const vector<cooked_kerning>& kernings)
+{
+    bool     ret = false;
+    ofstream out(path);
+    if (out)
+    {
+        out << "info face=\"" << face << "\" size=" << ptsize << " unicode=1 padding=0,0,0,0 spacing=" << PADDING << "," << PADDING
+            << endl;
+        out << "common lineHeight=" << line_height << " base=" << line_height << " scaleW=" << PAGE_SIZE << " scaleH=" << PAGE_SIZE
+            << " pages=" << page_files.size() << " packed=0" << endl;
+        for (size_t i = 0; i < page_files.size(); i++)
+        {
+            out << "page id=" << i << " file=\"" << page_files[i] << "\"" << endl;
+        }
+        out << "chars count=" << glyphs.size() << endl;
+        for (const auto& glyph : glyphs)
+        {
+            out << "char id=" << glyph.ch << " x=" << glyph.rect.x << " y=" << glyph.rect.y << " width=" << glyph.rect.w
+                << " height=" << glyph.rect.h << " xoffset=" << glyph.offset_x << " yoffset=" << glyph.offset_y
+                << " xadvance=" << glyph.advance << " page=" << glyph.page << " chnl=15" << endl;
+        }
+        out << "kernings count=" << kernings.size() << endl;
+        for (const auto& kerning : kernings)
+        {
+            out << "kerning first=" << kerning.first << " second=" << kerning.second << " amount=" << kerning.amount << endl;
+        }
+        ret = static_cast<bool>(out);
+    }
+    return ret;
+}
+
+/** @brief Entry point */
+int main(int argc, char* argv[])
+{
+    int ret = EXIT_FAILURE;
+
+    // Initalize SDL
+    auto sdl_lib = sdl::init(SDL_INIT_VIDEO);
+    if (argc != 4)
+    {
+        cerr << "Usage : " << argv[0] << " <font file or directory> <point size> <output directory>" << endl;
+    }
+    else if (sdl_lib)
+    {
+        int              ptsize = atoi(argv[2]);
+        filesystem::path output(argv[3]);
+        auto             fonts = find_fonts(argv[1]);
+        bool             is_ok = (ptsize > 0) && !fonts.empty();
+        error_code       error;
+        filesystem::create_directories(output, error);
+        for (auto iter = fonts.begin(); is_ok && (iter != fonts.end()); ++iter)
+        {
+            // Rasterize the glyphs
+            string                 name = iter->stem().string() + "_" + to_string(ptsize);
+            sdl::font              font = sdl::create_font(iter->string(), ptsize);
+            vector<sdl::surface>   pages;
+            vector<cooked_glyph>   glyphs;
+            vector<cooked_kerning> kernings;
+            is_ok = (font && cook_glyphs(font, pages, glyphs));
+            if (is_ok)
+            {
+                kernings = cook_kernings(font, glyphs);
+            }
+
+            // Write the pages and the description
+            vector<string> page_files;
+            for (size_t i = 0; is_ok && (i < pages.size()); i++)
+            {
+                page_files.push_back(name + "_" + to_string(i) + ".png");
+                is_ok = pages[i]->save_png((output / page_files.back()).string());
+            }
+            is_ok = is_ok && write_description(output / (name + ".fnt"),
+                                               iter->stem().string(),
+                                               ptsize,
+                                               font->get_line_skip(),
+                                               page_files,
+                                               glyphs,
+                                               kernings);
+            if (is_ok)
+            {
+                cout << name << " : " << glyphs.size() << " glyphs, " << kernings.size() << " kernings, " << pages.size() << " pages"
+                     << endl;
+            }
+            else
+            {
+                cerr << "Unable to convert " << iter->string() << " : " << sdl_lib->last_error() << endl;
+            }
+        }
+        if (is_ok)
+        {
+            ret = EXIT_SUCCESS;
+        }
+    }
+    else
+    {
+        cerr << "Unable to initialize SDL library : " << sdl::last_error() << endl;
+    }
+
+    return ret;
+}
@@ -0,0 +1,310 @@
+/*
+MIT License
+
+Copyright (c) 2023 Cedric Jimenez
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <vector>
+
+#include "sdl.h"
+#include "sdl_surface.h"
+#include "sprite_bundle.h"
+
+using namespace std;
+using namespace game;
+
+/** @brief Image file of an animation */
+struct frame_file
+{
+    /** @brief Image number */
+    Uint32 number;
+    /** @brief Path to the file */
+    string file;
+};
+
+/** @brief Pixels of a frame, trimmed and packed without padding */
+struct frame_pixels
+{
+    /** @brief Width in pixels */
+    Uint32 width;
+    /** @brief Height in pixels */
+    Uint32 height;
+    /** @brief Rows of pixels */
+    string rows;
+
+    /** @brief Comparison operator */
+    bool operator<(const frame_pixels& other) const { return (tie(width, height, rows) < tie(other.width, other.height, other.rows)); }
+};
+
+/** @brief Look for the animations in a directory tree : files named <base name>_<number>.<ext> are the frames of
+ *         the animation named <relative directory>/<base name> */
+static bool find_animations(const filesystem::path& root, map<string, vector<frame_file>>& animations)
+{
+    // Browse the tree without exceptions so that an unreadable directory is reported as an error
+    error_code                               ec;
+    regex                                    filter("(.+)_([0-9]+)\\.[A-Za-z]+");
+    filesystem::recursive_directory_iterator iter(root, ec);
+    for (; !ec && (iter != filesystem::recursive_directory_iterator()); iter.increment(ec))
+    {
+        const auto& dir_entry = *iter;
+        error_code  type_ec;
+        smatch      match;
+        string      file = dir_entry.path().filename().string();
+        if (dir_entry.is_regular_file(type_ec) && regex_match(file, match, filter))
+        {
+            string dir  = dir_entry.path().parent_path().lexically_relative(root).generic_string();
+            string name = ((dir == ".") ? match[1].str() : (dir + "/" + match[1].str()));
+            animations[name].push_back({static_cast<Uint32>(atoi(match[2].str().c_str())), dir_entry.path().string()});
+        }
+    }
+    for (auto& [name, frames] : animations)
+    {
+        sort(frames.begin(), frames.end(), [](const frame_file& a, const frame_file& b) { return (a.number < b.number); });
+    }
+
+    return !ec;
+}
+
+/** @brief Trim the fully transparent borders of a frame, a fully transparent frame is reduced to its top left pixel */
+static frame_pixels trim_frame(const sdl::surface& image, SDL_Rect& bounds)
+{
+    // Look for the non transparent area
+    const Uint32 alpha_mask = 0xFF000000u;
+    SDL_Rect     size       = image->get_size();
+    int          min_x      = size.w;
+    int          max_x      = -1;
+    int          min_y      = size.h;
+    int          max_y      = -1;
+    for (int y = 0; y < size.h; y++)
+    {
+        const Uint32* line = reinterpret_cast<const Uint32*>(static_cast<const Uint8*>(image->get_pixels()) + y * image->get_pitch());
+        for (int x = 0; x < size.w; x++)
+        {
+            if ((line[x] & alpha_mask) != 0u)
+            {
+                min_x = min(min_x, x);
+                max_x = max(max_x, x);
+                min_y = min(min_y, y);
+                max_y = y;
+            }
+        }
+    }
+    bounds = ((max_y >= 0) ? SDL_Rect{min_x, min_y, max_x - min_x + 1, max_y - min_y + 1} : SDL_Rect{0, 0, 1, 1});
+
+    // Pack the rows of the area
+    frame_pixels pixels;
+    size_t       row_size = static_cast<size_t>(bounds.w) * sizeof(Uint32);
+    const char*  row      = static_cast<const char*>(image->get_pixels()) + bounds.y * image->get_pitch() +
+                      static_cast<size_t>(bounds.x) * sizeof(Uint32);
+    pixels.width          = static_cast<Uint32>(bounds.w);
+    pixels.height         = static_cast<Uint32>(bounds.h);
+    for (int y = 0; y < bounds.h; y++, row += image->get_pitch())
+    {
+        pixels.rows.append(row, row_size);
+    }
+    return pixels;
+}
+
+/** @brief Align an offset in the bundle */
+static Uint64 align(Uint64 offset)
+{
+    return ((offset + BUNDLE_ALIGNMENT - 1u) / BUNDLE_ALIGNMENT) * BUNDLE_ALIGNMENT;
+}
+
+/** @brief Write the padding needed to reach an aligned offset */
+static void write_padding(ofstream& out, Uint64& offset)
+{
+    static const char zeros[BUNDLE_ALIGNMENT] = {};
+    Uint64            aligned                 = align(offset);
+    out.write(zeros, static_cast<streamsize>(aligned - offset));
+    offset = aligned;
+}
+
+/** @brief Write the bundle file */
+static bool write_bundle(const string&                      path,
+                         const bundle_header&               header,
+                         const vector<bundle_animation>&    animations,
+                         const vector<bundle_frame>&        frames,
+                         const string&                      names,
+                         const vector<const frame_pixels*>& unique_pixels)
+{
+    bool     ret = false;
+    ofstream out(path, ios::binary);
+    if (out)
+    {
+        // Tables
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(animations.data()), static_cast<streamsize>(animations.size() * sizeof(bundle_animation)));
+        out.write(reinterpret_cast<const char*>(frames.data()), static_cast<streamsize>(frames.size() * sizeof(bundle_frame)));
+        out.write(names.data(), static_cast<streamsize>(names.size()));
+
+        // Pixels, each unique frame is written once
+        Uint64 offset =
+            sizeof(bundle_header) + animations.size() * sizeof(bundle_animation) + frames.size() * sizeof(bundle_frame) + names.size();
+        write_padding(out, offset);
+        for (const auto& pixels : unique_pixels)
+        {
+            out.write(pixels->rows.data(), static_cast<streamsize>(pixels->rows.size()));
+            offset += pixels->rows.size();
+            write_padding(out, offset);
+        }
+
+        ret = static_cast<bool>(out);
+    }
+    return ret;
+}
+
+/** @brief Entry point */
+int main(int argc, char* argv[])
+{
+    int ret = EXIT_FAILURE;
+
+    // Pixels are stored in the format of the sprites texture atlas
+    const Uint32 pixel_format = SDL_PIXELFORMAT_ARGB8888;
+
+    // Initalize SDL
+    auto sdl_lib = sdl::init(SDL_INIT_VIDEO);
+    if (argc != 3)
+    {
+        cerr << "Usage : " << argv[0] << " <sprites directory> <output bundle>" << endl;
+    }
+    else if (sdl_lib)
+    {
+        // Decode, trim and share all the frames
+        map<string, vector<frame_file>> animations;
+        vector<bundle_animation>        anim_entries;
+        vector<bundle_frame>            frames;
+        vector<size_t>                  frame_pixels_index;
+        map<frame_pixels, size_t>       pixels_index;
+        vector<const frame_pixels*>     unique_pixels;
+        string                          names;
+        bool                            is_ok = find_animations(argv[1], animations);
+        if (!is_ok)
+        {
+            cerr << "Unable to browse the sprites directory " << argv[1] << endl;
+        }
+        else if (animations.empty())
+        {
+            cerr << "No animation found in " << argv[1] << endl;
+            is_ok = false;
+        }
+        for (auto iter = animations.begin(); is_ok && (iter != animations.end()); ++iter)
+        {
+            anim_entries.push_back({static_cast<Uint32>(names.size()),
+                                    static_cast<Uint32>(iter->first.size()),
+                                    static_cast<Uint32>(frames.size()),
+                                    static_cast<Uint32>(iter->second.size())});
+            names += iter->first;
+
+            for (const auto& frame : iter->second)
+            {
+                sdl::surface image = sdl::create_surface(frame.file);
+                if (image)
+                {
+                    image = image->convert(pixel_format);
+                }
+                if (image)
+                {
+                    // Identical frames share the same pixels
+                    SDL_Rect     bounds;
+                    SDL_Rect     size   = image->get_size();
+                    frame_pixels pixels = trim_frame(image, bounds);
+                    auto         iter   = pixels_index.emplace(move(pixels), unique_pixels.size()).first;
+                    if (iter->second == unique_pixels.size())
+                    {
+                        unique_pixels.push_back(&iter->first);
+                    }
+                    frame_pixels_index.push_back(iter->second);
+                    frames.push_back({frame.number,
+                                      static_cast<Uint32>(bounds.w),
+                                      static_cast<Uint32>(bounds.h),
+                                      static_cast<Uint32>(bounds.w) * SDL_BYTESPERPIXEL(pixel_format),
+                                      0u,
+                                      static_cast<Uint32>(bounds.x),
+                                      static_cast<Uint32>(bounds.y),
+                                      static_cast<Uint32>(size.w),
+                                      static_cast<Uint32>(size.h)});
+                }
+                else
+                {
+                    cerr << "Unable to decode " << frame.file << " : " << sdl_lib->last_error() << endl;
+                    is_ok = false;
+                }
+            }
+            cout << iter->first << " : " << iter->second.size() << " frames" << endl;
+        }
+
+        // Compute the layout of the file
+        bundle_header header;
+        memcpy(header.magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC));
+        header.version         = BUNDLE_VERSION;
+        header.pixel_format    = pixel_format;
+        header.animation_count = static_cast<Uint32>(anim_entries.size());
+        header.frame_count     = static_cast<Uint32>(frames.size());
+        header.names_size      = static_cast<Uint32>(names.size());
+        header.pixels_offset   = align(sizeof(bundle_header) + anim_entries.size() * sizeof(bundle_animation) +
+                                     frames.size() * sizeof(bundle_frame) + names.size());
+
+        Uint64         offset = header.pixels_offset;
+        vector<Uint64> pixels_offsets;
+        for (const auto& pixels : unique_pixels)
+        {
+            pixels_offsets.push_back(offset);
+            offset = align(offset + pixels->rows.size());
+        }
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            frames[i].offset = pixels_offsets[frame_pixels_index[i]];
+        }
+
+        // Write the bundle
+        if (is_ok)
+        {
+            if (write_bundle(argv[2], header, anim_entries, frames, names, unique_pixels))
+            {
+                cout << "Bundle written to " << argv[2] << " (" << offset << " bytes, " << unique_pixels.size() << " unique frames out of "
+                     << frames.size() << ")" << endl;
+                ret = EXIT_SUCCESS;
+            }
+            else
+            {
+                cerr << "Unable to write the bundle " << argv[2] << endl;
+            }
+        }
+    }
+    else
+    {
+        cerr << "Unable to initialize SDL library : " << sdl::last_error() << endl;
+    }
+
+    return ret;
+}